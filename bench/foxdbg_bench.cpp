@@ -0,0 +1,569 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_bench.cpp
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Benchmarks
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <foxdbg.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/* each benchmark runs this long, within the iteration limits */
+#define BENCH_TIME_NS (500ULL * 1000ULL * 1000ULL)
+
+#define BENCH_MIN_ITERATIONS (20U)
+#define BENCH_MAX_ITERATIONS (20000U)
+
+/* writes per producer in the contention benchmark */
+#define CONTENTION_ITERATIONS (20000U)
+
+/* how long to wait for the server thread to take encode requests */
+#define BENCH_START_TIMEOUT_MS (5000U)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+typedef struct
+{
+    std::string group;
+    std::string name;
+    size_t size;                /* elements, pixels or producers depending on the group */
+    size_t payload_bytes;       /* bytes handed to foxdbg_write_channel */
+    size_t encoded_bytes;       /* bytes of messages built per payload, 0 for writes */
+    std::vector<uint64_t> samples_ns;
+} bench_result_t;
+
+typedef struct
+{
+    const char *name;
+    foxdbg_channel_type_t type;
+    size_t element_size;
+    std::vector<size_t> counts;
+} bench_payload_t;
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static uint64_t now_ns(void);
+template <typename F> static void run_samples(bench_result_t &result, F &&call);
+static bool run_encode_samples(bench_result_t &result, int channel_id, bool handoff);
+static std::vector<uint8_t> make_payload(foxdbg_channel_type_t type, size_t element_size, size_t count);
+static std::vector<uint8_t> make_image(int width, int height);
+static int add_bench_channel(const char *group, const char *name, size_t size, foxdbg_channel_type_t type);
+
+static void bench_write(std::vector<bench_result_t> &results);
+static bool bench_handoff(std::vector<bench_result_t> &results, int channel_id);
+static bool bench_encode(std::vector<bench_result_t> &results);
+static bool bench_jpeg(std::vector<bench_result_t> &results);
+static bool bench_contention(std::vector<bench_result_t> &results, size_t max_producers);
+
+static void write_results(FILE *file, const std::vector<bench_result_t> &results);
+static uint64_t percentile(const std::vector<uint64_t> &sorted, double p);
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+static const bench_payload_t payloads[] = {
+    { "float", FOXDBG_CHANNEL_TYPE_FLOAT, sizeof(float), { 1 } },
+    { "integer", FOXDBG_CHANNEL_TYPE_INTEGER, sizeof(int), { 1 } },
+    { "boolean", FOXDBG_CHANNEL_TYPE_BOOLEAN, sizeof(bool), { 1 } },
+    { "pose", FOXDBG_CHANNEL_TYPE_POSE, sizeof(foxdbg_pose_t), { 1 } },
+    { "location", FOXDBG_CHANNEL_TYPE_LOCATION, sizeof(foxdbg_location_t), { 1 } },
+    { "cubes", FOXDBG_CHANNEL_TYPE_CUBES, sizeof(foxdbg_cube_t), { 10, 100, 1000 } },
+    { "lines", FOXDBG_CHANNEL_TYPE_LINES, sizeof(foxdbg_line_t), { 10, 100, 1000 } },
+    { "spheres", FOXDBG_CHANNEL_TYPE_SPHERES, sizeof(foxdbg_sphere_t), { 10, 100, 1000 } },
+    { "arrows", FOXDBG_CHANNEL_TYPE_ARROWS, sizeof(foxdbg_arrow_t), { 10, 100, 1000 } },
+    { "triangles", FOXDBG_CHANNEL_TYPE_TRIANGLES, sizeof(foxdbg_triangle_t), { 10, 100, 1000 } },
+    { "text", FOXDBG_CHANNEL_TYPE_TEXT, sizeof(foxdbg_text_t), { 10, 100 } },
+    { "poses", FOXDBG_CHANNEL_TYPE_POSES, sizeof(foxdbg_pose_t), { 10, 100, 1000 } },
+    { "pointcloud", FOXDBG_CHANNEL_TYPE_POINTCLOUD, sizeof(foxdbg_vector4_t), { 1000, 10000, 100000 } },
+};
+
+static const int image_sizes[][2] = {
+    { 320, 240 },
+    { 640, 480 },
+    { 1280, 720 },
+    { 1920, 1080 },
+};
+
+static int channel_index = 0;
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+/*
+ * foxdbg_bench [output.json] [max producers]
+ *
+ * the library logs to stdout, so results go to a file, foxdbg_bench.json
+ * by default. run without a client connected. encodes run on the server
+ * thread and are timed there, the handoff group is the cost of getting
+ * a request to it and back.
+ */
+int main(int argc, char *argv[])
+{
+    const char *path = argc > 1 ? argv[1] : "foxdbg_bench.json";
+
+    size_t max_producers = argc > 2 ? (size_t)atoi(argv[2]) : std::max(4U, std::thread::hardware_concurrency());
+    max_producers = std::max<size_t>(max_producers, 1);
+
+    foxdbg_init();
+
+    /* the encoders are only usable once the server thread is up */
+    int probe = foxdbg_add_channel("/bench/probe", FOXDBG_CHANNEL_TYPE_FLOAT, 1);
+    size_t probe_size = 0;
+
+    uint64_t deadline = now_ns() + BENCH_START_TIMEOUT_MS * 1000000ULL;
+
+    while (foxdbg_encode_channel(probe, &probe_size, NULL) != 0)
+    {
+        if (now_ns() > deadline)
+        {
+            fprintf(stderr, "Server did not take encode requests, is the port in use or a client connected?\n");
+            foxdbg_shutdown();
+            return 1;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::vector<bench_result_t> results;
+
+    bench_write(results);
+
+    bool encoded = bench_handoff(results, probe) &&
+        bench_encode(results) &&
+        bench_jpeg(results) &&
+        bench_contention(results, max_producers);
+
+    foxdbg_shutdown();
+
+    if (!encoded)
+    {
+        fprintf(stderr, "Encode refused, a client connected or recording started during the run\n");
+        return 1;
+    }
+
+    FILE *file = fopen(path, "w");
+
+    if (!file)
+    {
+        fprintf(stderr, "Failed to open %s\n", path);
+        return 1;
+    }
+
+    write_results(file, results);
+    fclose(file);
+
+    printf("Wrote %zu benchmarks to %s\n", results.size(), path);
+
+    return 0;
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+static uint64_t now_ns(void)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* time call until BENCH_TIME_NS has passed, at least BENCH_MIN_ITERATIONS times */
+template <typename F> static void run_samples(bench_result_t &result, F &&call)
+{
+    uint64_t end = now_ns() + BENCH_TIME_NS;
+    result.samples_ns.reserve(BENCH_MAX_ITERATIONS);
+
+    while (result.samples_ns.size() < BENCH_MAX_ITERATIONS)
+    {
+        uint64_t start = now_ns();
+        call();
+        uint64_t stop = now_ns();
+
+        result.samples_ns.push_back(stop - start);
+
+        if (stop > end && result.samples_ns.size() >= BENCH_MIN_ITERATIONS)
+        {
+            break;
+        }
+    }
+}
+
+/*
+ * encode time measured on the server thread, or with handoff the rest of
+ * the round trip to it. false as soon as a request is refused
+ */
+static bool run_encode_samples(bench_result_t &result, int channel_id, bool handoff)
+{
+    uint64_t end = now_ns() + BENCH_TIME_NS;
+    result.samples_ns.reserve(BENCH_MAX_ITERATIONS);
+
+    while (result.samples_ns.size() < BENCH_MAX_ITERATIONS)
+    {
+        uint64_t encode_time = 0;
+        uint64_t start = now_ns();
+
+        /* encoded_bytes stays 0 if the messages do not fit the tx buffer */
+        if (foxdbg_encode_channel(channel_id, &result.encoded_bytes, &encode_time) != 0)
+        {
+            return false;
+        }
+
+        uint64_t stop = now_ns();
+        uint64_t round_trip = stop - start;
+
+        if (handoff)
+        {
+            result.samples_ns.push_back(round_trip > encode_time ? round_trip - encode_time : 0);
+        }
+        else
+        {
+            result.samples_ns.push_back(encode_time);
+        }
+
+        if (stop > end && result.samples_ns.size() >= BENCH_MIN_ITERATIONS)
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+/* elements filled with varying values, so encoders do not hit any shortcuts */
+static std::vector<uint8_t> make_payload(foxdbg_channel_type_t type, size_t element_size, size_t count)
+{
+    std::vector<uint8_t> payload(element_size * count);
+
+    if (type == FOXDBG_CHANNEL_TYPE_BOOLEAN)
+    {
+        payload[0] = 1;
+        return payload;
+    }
+
+    if (type == FOXDBG_CHANNEL_TYPE_INTEGER)
+    {
+        int value = 12345;
+        memcpy(payload.data(), &value, sizeof(value));
+        return payload;
+    }
+
+    if (type == FOXDBG_CHANNEL_TYPE_TEXT)
+    {
+        foxdbg_text_t *texts = (foxdbg_text_t *)payload.data();
+
+        for (size_t i = 0; i < count; i++)
+        {
+            texts[i].position = { (float)i, 0.0f, 0.0f };
+            texts[i].font_size = 12.0f;
+            texts[i].color = { 1.0f, 1.0f, 1.0f, 1.0f };
+            snprintf(texts[i].text, sizeof(texts[i].text), "label %zu", i);
+        }
+
+        return payload;
+    }
+
+    /* every other payload is made of floats, or doubles for locations */
+    if (type == FOXDBG_CHANNEL_TYPE_LOCATION)
+    {
+        foxdbg_location_t location = { 1700000000U, 0U, 51.5, -0.12, 35.0 };
+        memcpy(payload.data(), &location, sizeof(location));
+        return payload;
+    }
+
+    float *values = (float *)payload.data();
+    size_t value_count = payload.size() / sizeof(float);
+
+    for (size_t i = 0; i < value_count; i++)
+    {
+        values[i] = (float)((i * 7919U) % 1000U) * 0.01f + 0.5f;
+    }
+
+    return payload;
+}
+
+/* smooth gradients with some noise, compresses like a camera frame */
+static std::vector<uint8_t> make_image(int width, int height)
+{
+    std::vector<uint8_t> image((size_t)width * (size_t)height * 3U);
+    uint32_t noise = 1;
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            noise = noise * 1664525U + 1013904223U;
+
+            uint8_t *pixel = &image[((size_t)y * (size_t)width + (size_t)x) * 3U];
+            pixel[0] = (uint8_t)((x * 255) / width + (noise >> 29));
+            pixel[1] = (uint8_t)((y * 255) / height + ((noise >> 26) & 7U));
+            pixel[2] = (uint8_t)(((x + y) * 127) / (width + height) + ((noise >> 23) & 7U));
+        }
+    }
+
+    return image;
+}
+
+static int add_bench_channel(const char *group, const char *name, size_t size, foxdbg_channel_type_t type)
+{
+    char topic[128];
+    snprintf(topic, sizeof(topic), "/bench/%s/%s/%zu/%d", group, name, size, channel_index++);
+
+    return foxdbg_add_channel(topic, type, 1000);
+}
+
+/* latency of foxdbg_write_channel per type and payload size */
+static void bench_write(std::vector<bench_result_t> &results)
+{
+    for (const bench_payload_t &payload : payloads)
+    {
+        for (size_t count : payload.counts)
+        {
+            int channel_id = add_bench_channel("write", payload.name, count, payload.type);
+            std::vector<uint8_t> data = make_payload(payload.type, payload.element_size, count);
+
+            bench_result_t result = { "write", payload.name, count, data.size(), 0, {} };
+
+            run_samples(result, [&] {
+                foxdbg_write_channel(channel_id, data.data(), data.size());
+            });
+
+            results.push_back(std::move(result));
+        }
+    }
+}
+
+/* round trip of an encode request to the server thread, less the encode itself */
+static bool bench_handoff(std::vector<bench_result_t> &results, int channel_id)
+{
+    float value = 1.0f;
+    foxdbg_write_channel(channel_id, &value, sizeof(value));
+
+    bench_result_t result = { "handoff", "float", 1, sizeof(value), 0, {} };
+
+    if (!run_encode_samples(result, channel_id, true))
+    {
+        return false;
+    }
+
+    results.push_back(std::move(result));
+    return true;
+}
+
+/* time each send_* encoder takes to build the messages for one payload */
+static bool bench_encode(std::vector<bench_result_t> &results)
+{
+    for (const bench_payload_t &payload : payloads)
+    {
+        for (size_t count : payload.counts)
+        {
+            int channel_id = add_bench_channel("encode", payload.name, count, payload.type);
+            std::vector<uint8_t> data = make_payload(payload.type, payload.element_size, count);
+
+            foxdbg_write_channel(channel_id, data.data(), data.size());
+
+            bench_result_t result = { "encode", payload.name, count, data.size(), 0, {} };
+
+            if (!run_encode_samples(result, channel_id, false))
+            {
+                return false;
+            }
+
+            results.push_back(std::move(result));
+        }
+    }
+
+    return true;
+}
+
+/* raw RGB frames through the image encoder */
+static bool bench_jpeg(std::vector<bench_result_t> &results)
+{
+    for (const auto &image_size : image_sizes)
+    {
+        int width = image_size[0];
+        int height = image_size[1];
+
+        int channel_id = add_bench_channel("jpeg", "rgb", (size_t)width * (size_t)height, FOXDBG_CHANNEL_TYPE_IMAGE);
+
+        foxdbg_image_info_t image_info;
+        image_info.width = width;
+        image_info.height = height;
+        image_info.channels = 3;
+        image_info.format = FOXDBG_PIXEL_FORMAT_RGB;
+
+        foxdbg_write_channel_info(channel_id, &image_info, sizeof(image_info));
+
+        std::vector<uint8_t> image = make_image(width, height);
+        foxdbg_write_channel(channel_id, image.data(), image.size());
+
+        char name[32];
+        snprintf(name, sizeof(name), "rgb_%dx%d", width, height);
+
+        bench_result_t result = { "jpeg", name, (size_t)width * (size_t)height, image.size(), 0, {} };
+
+        if (!run_encode_samples(result, channel_id, false))
+        {
+            return false;
+        }
+
+        results.push_back(std::move(result));
+    }
+
+    return true;
+}
+
+/* 1..max_producers threads writing one channel while it is encoded, as the server would */
+static bool bench_contention(std::vector<bench_result_t> &results, size_t max_producers)
+{
+    const bench_payload_t &payload = payloads[5]; /* cubes */
+    const size_t count = 100;
+
+    std::vector<uint8_t> data = make_payload(payload.type, payload.element_size, count);
+
+    for (size_t producers = 1; producers <= max_producers; producers++)
+    {
+        int channel_id = add_bench_channel("contention", payload.name, producers, payload.type);
+        foxdbg_write_channel(channel_id, data.data(), data.size());
+
+        std::vector<std::vector<uint64_t>> samples(producers);
+        std::vector<std::thread> threads;
+        std::atomic_bool go(false);
+        std::atomic_size_t remaining(producers);
+
+        for (size_t p = 0; p < producers; p++)
+        {
+            threads.emplace_back([&, p] {
+                samples[p].reserve(CONTENTION_ITERATIONS);
+
+                while (!go.load())
+                {
+                    std::this_thread::yield();
+                }
+
+                for (size_t i = 0; i < CONTENTION_ITERATIONS; i++)
+                {
+                    uint64_t start = now_ns();
+                    foxdbg_write_channel(channel_id, data.data(), data.size());
+                    samples[p].push_back(now_ns() - start);
+                }
+
+                remaining--;
+            });
+        }
+
+        go.store(true);
+
+        /* the server thread holds the front buffer while it encodes */
+        size_t encoded_bytes = 0;
+        bool encoded = true;
+
+        while (remaining.load() > 0 && encoded)
+        {
+            encoded = foxdbg_encode_channel(channel_id, &encoded_bytes, NULL) == 0;
+        }
+
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+
+        if (!encoded)
+        {
+            return false;
+        }
+
+        bench_result_t result = { "contention", payload.name, producers, data.size(), encoded_bytes, {} };
+
+        for (const std::vector<uint64_t> &producer_samples : samples)
+        {
+            result.samples_ns.insert(result.samples_ns.end(), producer_samples.begin(), producer_samples.end());
+        }
+
+        results.push_back(std::move(result));
+    }
+
+    return true;
+}
+
+static void write_results(FILE *file, const std::vector<bench_result_t> &results)
+{
+    fprintf(file, "{\n  \"benchmarks\": [\n");
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const bench_result_t &result = results[i];
+
+        std::vector<uint64_t> sorted = result.samples_ns;
+        std::sort(sorted.begin(), sorted.end());
+
+        uint64_t total = 0;
+        for (uint64_t sample : sorted)
+        {
+            total += sample;
+        }
+
+        double mean = sorted.empty() ? 0.0 : (double)total / (double)sorted.size();
+
+        /* payload bytes moved per second through the benchmarked call */
+        double throughput = mean > 0.0 ? (double)result.payload_bytes * 1e9 / mean : 0.0;
+
+        fprintf(file,
+            "    {\"group\": \"%s\", \"name\": \"%s\", \"size\": %zu, \"payload_bytes\": %zu, \"encoded_bytes\": %zu, "
+            "\"iterations\": %zu, \"p50_ns\": %llu, \"p90_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu, "
+            "\"mean_ns\": %.1f, \"bytes_per_s\": %.0f}%s\n",
+            result.group.c_str(), result.name.c_str(), result.size, result.payload_bytes, result.encoded_bytes,
+            sorted.size(),
+            (unsigned long long)percentile(sorted, 0.50),
+            (unsigned long long)percentile(sorted, 0.90),
+            (unsigned long long)percentile(sorted, 0.99),
+            (unsigned long long)(sorted.empty() ? 0 : sorted.back()),
+            mean, throughput,
+            i + 1 < results.size() ? "," : ""
+        );
+    }
+
+    fprintf(file, "  ]\n}\n");
+}
+
+/* nearest rank */
+static uint64_t percentile(const std::vector<uint64_t> &sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+
+    size_t rank = (size_t)(p * (double)sorted.size());
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
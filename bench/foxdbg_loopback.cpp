@@ -0,0 +1,544 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_loopback.cpp
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Loopback Client
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <libwebsockets.h>
+
+#include <json/json.hpp>
+
+#include <foxdbg.h>
+
+using json = nlohmann::json;
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+#define LOOPBACK_PROTOCOL "foxglove.websocket.v1"
+
+#define LOOPBACK_DEFAULT_ADDRESS "127.0.0.1"
+#define LOOPBACK_DEFAULT_PORT (8765)
+#define LOOPBACK_DEFAULT_DURATION_S (10.0)
+
+/* channel written by the in-process server of -s */
+#define LOOPBACK_SERVE_TOPIC "/loopback/float"
+#define LOOPBACK_SERVE_PERIOD_US (1000U)
+#define LOOPBACK_SERVE_TIMEOUT_MS (5000U)
+
+/* opcode, subscription id, timestamp */
+#define MESSAGE_HEADER_SIZE (13U)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+typedef struct
+{
+    std::string topic;
+    uint64_t messages;
+    uint64_t bytes;
+    std::vector<uint64_t> latency_ns;   /* receive time minus the message timestamp */
+} loopback_channel_t;
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static int loopback_callback(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len);
+
+static void receive_text(struct lws *wsi, const uint8_t *data, size_t len);
+static void receive_binary(const uint8_t *data, size_t len, uint64_t now);
+static bool wanted_topic(const std::string &topic);
+
+static bool start_server(void);
+static void stop_server(void);
+
+static uint64_t now_ns(void);
+static uint64_t received_messages(void);
+static void write_report(FILE *file, double duration_s);
+static uint64_t percentile(const std::vector<uint64_t> &sorted, double p);
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+static struct lws_protocols protocols[] = {
+    {
+        LOOPBACK_PROTOCOL,          /* Protocol name */
+        loopback_callback,          /* Callback function */
+        0,                          /* Max frame size */
+        1024*1024,                  /* Buffer size */
+        0,                          /* Protocol id */
+        NULL,                       /* User pointer */
+        0                           /* Tx packet size, the buffer size */
+    },
+    { NULL, NULL, 0, 0, 0, NULL, 0 } /* Terminator */
+};
+
+static struct lws_context *context = NULL;
+
+static std::atomic_bool running(true);
+static bool connected = false;
+static bool failed = false;
+
+static std::vector<std::string> topics;
+
+/* lws hands over large messages in parts */
+static std::vector<uint8_t> message;
+
+/* subscribe request waiting for the socket to become writeable */
+static std::string pending;
+
+/* by subscription id, which is the index in the server's advertise */
+static std::map<uint32_t, loopback_channel_t> subscriptions;
+static uint64_t subscribe_time = 0;
+
+/* -s: foxdbg in this process, written by serve_thread */
+static std::thread serve_thread;
+static std::atomic_bool serving(false);
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+/*
+ * foxdbg_loopback [-a address] [-p port] [-d seconds] [-s] [topic ...]
+ *
+ * subscribes to the given topics, all of them if none are given, and
+ * prints per channel message rate, bytes per second and end-to-end
+ * latency as JSON on stdout. latency is the receive time minus the
+ * message timestamp, which is the write time for channels written with
+ * foxdbg_write_channel, so run on the same machine as the server.
+ *
+ * -s starts foxdbg in this process with one channel written at 1 kHz and
+ * fails unless messages arrive, for running unattended under ctest. the
+ * library's own logs go to stdout as well.
+ */
+int main(int argc, char *argv[])
+{
+    const char *address = LOOPBACK_DEFAULT_ADDRESS;
+    int port = LOOPBACK_DEFAULT_PORT;
+    double duration_s = LOOPBACK_DEFAULT_DURATION_S;
+    bool serve = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-a") == 0 && i + 1 < argc)
+        {
+            address = argv[++i];
+        }
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+        {
+            port = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+        {
+            duration_s = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-s") == 0)
+        {
+            serve = true;
+        }
+        else
+        {
+            topics.push_back(argv[i]);
+        }
+    }
+
+    if (serve && !start_server())
+    {
+        fprintf(stderr, "Failed to start the foxdbg server\n");
+        return 1;
+    }
+
+    lws_set_log_level(LLL_ERR | LLL_WARN, NULL);
+
+    struct lws_context_creation_info info;
+    memset(&info, 0, sizeof(info));
+
+    info.port = CONTEXT_PORT_NO_LISTEN;
+    info.protocols = protocols;
+    info.gid = -1;
+    info.uid = -1;
+
+    context = lws_create_context(&info);
+
+    if (!context)
+    {
+        fprintf(stderr, "libwebsockets init failed\n");
+        stop_server();
+        return 1;
+    }
+
+    struct lws_client_connect_info connect_info;
+    memset(&connect_info, 0, sizeof(connect_info));
+
+    connect_info.context = context;
+    connect_info.address = address;
+    connect_info.port = port;
+    connect_info.path = "/";
+    connect_info.host = address;
+    connect_info.origin = address;
+    connect_info.protocol = LOOPBACK_PROTOCOL;
+
+    if (!lws_client_connect_via_info(&connect_info))
+    {
+        fprintf(stderr, "Failed to connect to %s:%d\n", address, port);
+        lws_context_destroy(context);
+        stop_server();
+        return 1;
+    }
+
+    /* lws_service blocks while nothing arrives, wake it when the time is up */
+    std::thread timer([duration_s] {
+        auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(duration_s);
+
+        while (running.load() && std::chrono::steady_clock::now() < end)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        running.store(false);
+        lws_cancel_service(context);
+    });
+
+    while (running.load() && !failed)
+    {
+        lws_service(context, 0);
+    }
+
+    uint64_t end_time = now_ns();
+
+    running.store(false);
+    timer.join();
+
+    lws_context_destroy(context);
+    stop_server();
+
+    if (failed || !connected)
+    {
+        fprintf(stderr, "Connection to %s:%d failed\n", address, port);
+        return 1;
+    }
+
+    double measured_s = subscribe_time ? (double)(end_time - subscribe_time) / 1e9 : 0.0;
+    write_report(stdout, measured_s);
+
+    if (serve && received_messages() == 0)
+    {
+        fprintf(stderr, "No messages received from the server\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+static int loopback_callback(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len)
+{
+    (void)user;
+
+    switch (reason)
+    {
+        case LWS_CALLBACK_CLIENT_ESTABLISHED:
+        {
+            connected = true;
+        } break;
+
+        case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
+        {
+            fprintf(stderr, "Connection error: %s\n", in ? (const char *)in : "unknown");
+            failed = true;
+        } break;
+
+        case LWS_CALLBACK_CLIENT_CLOSED:
+        {
+            if (running.load())
+            {
+                fprintf(stderr, "Server closed the connection\n");
+                running.store(false);
+            }
+        } break;
+
+        case LWS_CALLBACK_CLIENT_RECEIVE:
+        {
+            uint64_t now = now_ns();
+
+            const uint8_t *data = (const uint8_t *)in;
+            message.insert(message.end(), data, data + len);
+
+            if (!lws_is_final_fragment(wsi) || lws_remaining_packet_payload(wsi) != 0)
+            {
+                break;
+            }
+
+            /* stamped on the last part, as a client would see the whole message */
+            if (lws_frame_is_binary(wsi))
+            {
+                receive_binary(message.data(), message.size(), now);
+            }
+            else
+            {
+                receive_text(wsi, message.data(), message.size());
+            }
+
+            message.clear();
+        } break;
+
+        case LWS_CALLBACK_CLIENT_WRITEABLE:
+        {
+            if (pending.empty())
+            {
+                break;
+            }
+
+            std::vector<uint8_t> buffer(LWS_PRE + pending.size());
+            memcpy(buffer.data() + LWS_PRE, pending.data(), pending.size());
+
+            lws_write(wsi, buffer.data() + LWS_PRE, pending.size(), LWS_WRITE_TEXT);
+
+            pending.clear();
+            subscribe_time = now_ns();
+        } break;
+
+        default:
+        {
+            /* unhandled case */
+        } break;
+    }
+
+    return 0;
+}
+
+/* subscribe to the wanted topics of the first advertise */
+static void receive_text(struct lws *wsi, const uint8_t *data, size_t len)
+{
+    json op = json::parse(data, data + len, nullptr, false);
+
+    if (op.is_discarded() || op.value("op", "") != "advertise" || !subscriptions.empty())
+    {
+        return;
+    }
+
+    json request = {
+        {"op", "subscribe"},
+        {"subscriptions", json::array()}
+    };
+
+    for (const json &channel : op["channels"])
+    {
+        std::string topic = channel.value("topic", "");
+
+        if (!wanted_topic(topic))
+        {
+            continue;
+        }
+
+        uint32_t subscription_id = (uint32_t)subscriptions.size();
+
+        subscriptions[subscription_id] = { topic, 0, 0, {} };
+        request["subscriptions"].push_back({
+            {"id", subscription_id},
+            {"channelId", channel.value("id", 0)}
+        });
+    }
+
+    if (subscriptions.empty())
+    {
+        fprintf(stderr, "None of the requested topics are advertised\n");
+        running.store(false);
+        return;
+    }
+
+    pending = request.dump();
+    lws_callback_on_writable(wsi);
+}
+
+static void receive_binary(const uint8_t *data, size_t len, uint64_t now)
+{
+    if (len < MESSAGE_HEADER_SIZE || data[0] != 0x01)
+    {
+        return; /* not a message, e.g. the playback time */
+    }
+
+    uint32_t subscription_id = 0;
+    uint64_t timestamp = 0;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        subscription_id |= (uint32_t)data[1 + i] << (8 * i);
+    }
+
+    for (int i = 0; i < 8; ++i)
+    {
+        timestamp |= (uint64_t)data[5 + i] << (8 * i);
+    }
+
+    auto found = subscriptions.find(subscription_id);
+
+    if (found == subscriptions.end())
+    {
+        return;
+    }
+
+    loopback_channel_t &channel = found->second;
+    channel.messages++;
+    channel.bytes += len;
+    channel.latency_ns.push_back(now > timestamp ? now - timestamp : 0);
+}
+
+static bool wanted_topic(const std::string &topic)
+{
+    return topics.empty() || std::find(topics.begin(), topics.end(), topic) != topics.end();
+}
+
+/* foxdbg with one channel written until stop_server, true once it takes clients */
+static bool start_server(void)
+{
+    foxdbg_init();
+
+    int channel_id = foxdbg_add_channel(LOOPBACK_SERVE_TOPIC, FOXDBG_CHANNEL_TYPE_FLOAT, 1000);
+
+    serving.store(true);
+
+    serve_thread = std::thread([channel_id] {
+        float value = 0.0f;
+
+        while (serving.load())
+        {
+            foxdbg_write_channel(channel_id, &value, sizeof(value));
+            value += 1.0f;
+
+            std::this_thread::sleep_for(std::chrono::microseconds(LOOPBACK_SERVE_PERIOD_US));
+        }
+    });
+
+    /* encodes are only accepted once the server thread is up, and while nobody is connected */
+    uint64_t deadline = now_ns() + LOOPBACK_SERVE_TIMEOUT_MS * 1000000ULL;
+    size_t encoded_size = 0;
+
+    while (foxdbg_encode_channel(channel_id, &encoded_size, NULL) != 0)
+    {
+        if (now_ns() > deadline)
+        {
+            stop_server();
+            return false;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    return true;
+}
+
+static void stop_server(void)
+{
+    if (!serving.load())
+    {
+        return;
+    }
+
+    serving.store(false);
+    serve_thread.join();
+
+    foxdbg_shutdown();
+}
+
+static uint64_t received_messages(void)
+{
+    uint64_t total = 0;
+
+    for (const auto &entry : subscriptions)
+    {
+        total += entry.second.messages;
+    }
+
+    return total;
+}
+
+/* the clock foxdbg stamps messages with */
+static uint64_t now_ns(void)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static void write_report(FILE *file, double duration_s)
+{
+    fprintf(file, "{\n  \"duration_s\": %.3f,\n  \"channels\": [\n", duration_s);
+
+    size_t index = 0;
+
+    for (auto &entry : subscriptions)
+    {
+        loopback_channel_t &channel = entry.second;
+        std::sort(channel.latency_ns.begin(), channel.latency_ns.end());
+
+        uint64_t total = 0;
+        for (uint64_t latency : channel.latency_ns)
+        {
+            total += latency;
+        }
+
+        double mean = channel.latency_ns.empty() ? 0.0 : (double)total / (double)channel.latency_ns.size();
+
+        fprintf(file,
+            "    {\"topic\": \"%s\", \"messages\": %llu, \"bytes\": %llu, \"msg_per_s\": %.2f, \"bytes_per_s\": %.0f, "
+            "\"latency_us\": {\"mean\": %.1f, \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f}}%s\n",
+            channel.topic.c_str(),
+            (unsigned long long)channel.messages,
+            (unsigned long long)channel.bytes,
+            duration_s > 0.0 ? (double)channel.messages / duration_s : 0.0,
+            duration_s > 0.0 ? (double)channel.bytes / duration_s : 0.0,
+            mean / 1e3,
+            (double)percentile(channel.latency_ns, 0.50) / 1e3,
+            (double)percentile(channel.latency_ns, 0.90) / 1e3,
+            (double)percentile(channel.latency_ns, 0.99) / 1e3,
+            (double)(channel.latency_ns.empty() ? 0 : channel.latency_ns.back()) / 1e3,
+            ++index < subscriptions.size() ? "," : ""
+        );
+    }
+
+    fprintf(file, "  ]\n}\n");
+}
+
+/* nearest rank */
+static uint64_t percentile(const std::vector<uint64_t> &sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+
+    size_t rank = (size_t)(p * (double)sorted.size());
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
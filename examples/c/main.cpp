@@ -47,6 +47,8 @@ int main(int argc, char *argv[])
     int channel_id4 = foxdbg_add_channel("/waves/bool", FOXDBG_CHANNEL_TYPE_BOOLEAN, 30);
     int channel_id5 = foxdbg_add_channel("/waves/int", FOXDBG_CHANNEL_TYPE_INTEGER, 30);
 
+    foxdbg_add_channel(FOXDBG_STATS_TOPIC, FOXDBG_CHANNEL_TYPE_STATS, FOXDBG_STATS_HZ);
+
     int rx_channel = foxdbg_add_rx_channel("/rx/system_state", FOXDBG_CHANNEL_TYPE_BOOLEAN);
 
     int width, height, channels;
@@ -58,6 +60,7 @@ int main(int argc, char *argv[])
     image_info.width = width;
     image_info.height = height;
     image_info.channels = channels;
+    image_info.format = FOXDBG_PIXEL_FORMAT_RGB;
 
     foxdbg_write_channel_info(channel_id, &image_info, sizeof(image_info));
 
@@ -69,6 +72,7 @@ int main(int argc, char *argv[])
     image_info2.width = width2;
     image_info2.height = height2;
     image_info2.channels = channels2;
+    image_info2.format = FOXDBG_PIXEL_FORMAT_RGB;
 
     foxdbg_write_channel_info(channel_id2, &image_info2, sizeof(image_info2));
 
@@ -96,6 +100,12 @@ int main(int argc, char *argv[])
 
         foxdbg_write_channel(channel_id5, &int_value, sizeof(int_value));
 
+        bool system_state;
+        if (foxdbg_read_rx_channel(rx_channel, &system_state, sizeof(system_state)) > 0)
+        {
+            foxdbg_write_channel(channel_id4, &system_state, sizeof(bool));
+        }
+
 
         YIELD_CPU();
     }
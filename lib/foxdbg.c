@@ -17,6 +17,15 @@
 
 #include "foxdbg.h"
 #include "foxdbg_thread.h"
+#include "foxdbg_atomic.h"
+#include "foxdbg_hash.h"
+#include "foxdbg_time.h"
+#include "foxdbg_frames.h"
+#include "foxdbg_recorder.h"
+#include "foxdbg_flight.h"
+#include "foxdbg_playback.h"
+#include "foxdbg_parameters.h"
+#include "foxdbg_events.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -35,6 +44,12 @@
 ** MARK: STATIC FUNCTION DEFS
 ***************************************************************/
 
+static void write_path(foxdbg_channel_t *channel, const foxdbg_pose_t *pose, uint64_t timestamp, uint64_t now);
+static void write_transform(foxdbg_channel_t *channel, const foxdbg_transform_t *transform, uint64_t timestamp, uint64_t now);
+static bool path_keep(const foxdbg_channel_t *channel, const foxdbg_pose_t *pose, uint64_t now);
+static void init_channel_defaults(foxdbg_channel_t *channel);
+static void dispatch_event(const foxdbg_event_t *event);
+
 /***************************************************************
 ** MARK: STATIC VARIABLES
 ***************************************************************/
@@ -45,6 +60,14 @@ static size_t channel_count = 0;
 static foxdbg_channel_t *rx_channels = NULL;
 static size_t rx_channel_count = 0;
 
+/* set from any thread, the callbacks only run inside foxdbg_update */
+static foxdbg_subscription_callback_t subscription_callback = NULL;
+static void *subscription_callback_user = NULL;
+static foxdbg_parameter_callback_t parameter_callback = NULL;
+static void *parameter_callback_user = NULL;
+
+static uint64_t update_budget_ns = 1000000; /* 1 ms */
+
 /***************************************************************
 ** MARK: PUBLIC FUNCTIONS
 ***************************************************************/
@@ -57,13 +80,35 @@ void foxdbg_init()
     rx_channels = NULL;
     rx_channel_count = 0;
 
-    foxdbg_thread_init(&channels, &channel_count);
+    foxdbg_thread_init(&channels, &channel_count, &rx_channels, &rx_channel_count);
+}
+
+void foxdbg_update(void)
+{
+    uint64_t start = foxdbg_time_ns();
+    uint64_t budget = ATOMIC_READ_U64(&update_budget_ns);
+
+    foxdbg_event_t event;
+
+    while (foxdbg_events_pop(&event))
+    {
+        dispatch_event(&event);
+
+        /* whatever is left waits for the next call */
+        if (budget && foxdbg_time_ns() - start >= budget)
+        {
+            break;
+        }
+    }
 }
 
 
 void foxdbg_shutdown(void)
 {
     foxdbg_thread_shutdown();
+    foxdbg_recorder_close();
+    foxdbg_flight_shutdown();
+    foxdbg_playback_close();
 }
 
 int foxdbg_add_channel(const char *topic_name, foxdbg_channel_type_t channel_type, int target_hz)
@@ -80,11 +125,27 @@ int foxdbg_add_channel(const char *topic_name, foxdbg_channel_type_t channel_typ
         } break;
 
         case FOXDBG_CHANNEL_TYPE_POINTCLOUD:
+        {
+            payload_size = LARGE_BUFFER_SIZE;
+            info_size = sizeof(foxdbg_pointcloud_info_t);
+        } break;
+
         case FOXDBG_CHANNEL_TYPE_CUBES:
         case FOXDBG_CHANNEL_TYPE_LINES:
+        case FOXDBG_CHANNEL_TYPE_SCENE:
+        case FOXDBG_CHANNEL_TYPE_SPHERES:
+        case FOXDBG_CHANNEL_TYPE_ARROWS:
+        case FOXDBG_CHANNEL_TYPE_TRIANGLES:
+        case FOXDBG_CHANNEL_TYPE_TEXT:
+        case FOXDBG_CHANNEL_TYPE_POSES:
         {
             payload_size = LARGE_BUFFER_SIZE;
         } break;
+
+        case FOXDBG_CHANNEL_TYPE_PATH:
+        {
+            payload_size = (FOXDBG_PATH_MAX_LENGTH + 1) * sizeof(foxdbg_pose_t);
+        } break;
         
         case FOXDBG_CHANNEL_TYPE_POSE:
         {
@@ -93,7 +154,12 @@ int foxdbg_add_channel(const char *topic_name, foxdbg_channel_type_t channel_typ
 
         case FOXDBG_CHANNEL_TYPE_TRANSFORM:
         {
-            payload_size = sizeof(foxdbg_transform_t);
+            payload_size = sizeof(foxdbg_frame_transform_t); /* names are interned on write */
+        } break;
+
+        case FOXDBG_CHANNEL_TYPE_TRANSFORMS:
+        {
+            payload_size = FOXDBG_MAX_FRAMES * sizeof(foxdbg_frame_transform_t);
         } break;
 
         case FOXDBG_CHANNEL_TYPE_LOCATION:
@@ -116,6 +182,16 @@ int foxdbg_add_channel(const char *topic_name, foxdbg_channel_type_t channel_typ
             payload_size = sizeof(bool);
         } break;
 
+        case FOXDBG_CHANNEL_TYPE_PLAYBACK:
+        {
+            payload_size = 1; /* messages are sent straight from the file */
+        } break;
+
+        case FOXDBG_CHANNEL_TYPE_STATS:
+        {
+            payload_size = 1; /* built from the other channels when sent */
+        } break;
+
         default:
         {
             return -1; /* Invalid channel type */
@@ -135,6 +211,16 @@ int foxdbg_add_channel(const char *topic_name, foxdbg_channel_type_t channel_typ
     }
     
 
+    foxdbg_pose_t *path_history = NULL;
+    if (channel_type == FOXDBG_CHANNEL_TYPE_PATH)
+    {
+        path_history = malloc(FOXDBG_PATH_MAX_LENGTH * sizeof(foxdbg_pose_t));
+        if (!path_history)
+        {
+            return -1; /* Failed to allocate path history */
+        }
+    }
+
     foxdbg_channel_t *new_channel = malloc(sizeof(foxdbg_channel_t));
     if (!new_channel)
     {
@@ -152,9 +238,9 @@ int foxdbg_add_channel(const char *topic_name, foxdbg_channel_type_t channel_typ
     new_channel->channel_type = channel_type;
     new_channel->data_buffer = data_buffer;
     new_channel->info_buffer = info_buffer;
-    new_channel->subscription_id = -1;
     new_channel->channel_id = channel_count;
-    new_channel->next = NULL;
+    init_channel_defaults(new_channel);
+    new_channel->path_history = path_history;
 
     foxdbg_channel_t *current = channels;
     
@@ -243,9 +329,8 @@ int foxdbg_add_rx_channel(const char *topic_name, foxdbg_channel_type_t channel_
     new_channel->channel_type = channel_type;
     new_channel->data_buffer = data_buffer;
     new_channel->info_buffer = NULL;
-    new_channel->subscription_id = -1;
     new_channel->channel_id = rx_channel_count;
-    new_channel->next = NULL;
+    init_channel_defaults(new_channel);
 
     foxdbg_channel_t *current = rx_channels;
 
@@ -285,29 +370,102 @@ int foxdbg_get_rx_channel(const char *topic_name)
     return -1; /* Channel not found */
 }
 
+int foxdbg_read_rx_channel(int channel_id, void *data, size_t size)
+{
+    foxdbg_channel_t *current = rx_channels;
+
+    while (current)
+    {
+        if (current->channel_id == channel_id)
+        {
+            if (size != current->data_buffer->buffer_size)
+            {
+                return -1; /* Size does not match the channel type */
+            }
+
+            uint64_t latest = ATOMIC_READ_U64(&current->rx_latest);
+            uint32_t value = (uint32_t)latest;
+            int sequence = (int)(latest >> 32);
+
+            if (sequence > 0)
+            {
+                memcpy(data, &value, size);
+            }
+
+            return sequence;
+        }
+
+        current = current->next;
+    }
+
+    return -1; /* Channel not found */
+}
+
 
 void foxdbg_write_channel(int channel_id, const void *data, size_t size)
 {
+    foxdbg_write_channel_stamped(channel_id, data, size, 0);
+}
+
+void foxdbg_write_channel_stamped(int channel_id, const void *data, size_t size, uint64_t timestamp)
+{
+    uint64_t now = foxdbg_time_ns();
+
+    if (timestamp == 0)
+    {
+        timestamp = now;
+    }
+
     foxdbg_channel_t *current = channels;
 
     while (current)
     {
         if (current->channel_id == channel_id)
         {
+            if (current->channel_type == FOXDBG_CHANNEL_TYPE_PATH)
+            {
+                if (size == sizeof(foxdbg_pose_t))
+                {
+                    write_path(current, (const foxdbg_pose_t *)data, timestamp, now);
+                }
+                return;
+            }
+
+            if (current->channel_type == FOXDBG_CHANNEL_TYPE_TRANSFORM)
+            {
+                if (size == sizeof(foxdbg_transform_t))
+                {
+                    write_transform(current, (const foxdbg_transform_t *)data, timestamp, now);
+                }
+                return;
+            }
+
             void *buffer_data = NULL;
             size_t buffer_size = 0;
 
             foxdbg_buffer_begin_write(current->data_buffer, &buffer_data, &buffer_size);
 
 
+            ATOMIC_WRITE_U64(&current->write_count, ATOMIC_READ_U64(&current->write_count) + 1);
+
             if (buffer_data && size <= buffer_size)
             {
                 memcpy(buffer_data, data, size);
+
+                /* hash the copy while it is still in cache, 0 means not hashed */
+                uint64_t hash = current->skip_unchanged ? foxdbg_hash(buffer_data, size) : 0;
+                foxdbg_buffer_set_hash(current->data_buffer, hash);
+                foxdbg_buffer_set_timestamp(current->data_buffer, timestamp, now);
+
                 foxdbg_buffer_end_write(current->data_buffer, size);
                 return;
             }
             else
             {
+                ATOMIC_WRITE_U64(&current->write_dropped, ATOMIC_READ_U64(&current->write_dropped) + 1);
+
+                foxdbg_buffer_set_hash(current->data_buffer, 0);
+                foxdbg_buffer_set_timestamp(current->data_buffer, timestamp, now);
                 foxdbg_buffer_end_write(current->data_buffer, 0);
                 return;
             }
@@ -342,6 +500,508 @@ void foxdbg_write_channel_info(int channel_id, const void *data, size_t size)
     }
 }
 
+int foxdbg_get_channel_latency(int channel_id, foxdbg_latency_t *latency)
+{
+    foxdbg_channel_t *current = channels;
+
+    while (current)
+    {
+        if (current->channel_id == channel_id)
+        {
+            /* counters may be mid-update, good enough for monitoring */
+            *latency = current->latency;
+            return 0;
+        }
+        current = current->next;
+    }
+
+    return -1; /* Channel not found */
+}
+
+int foxdbg_start_recording(const char *path)
+{
+    if (!foxdbg_recorder_open(path))
+    {
+        return -1;
+    }
+
+    /* the server thread only polls for payloads without a client while recording */
+    foxdbg_thread_wake();
+
+    return 0;
+}
+
+void foxdbg_stop_recording(void)
+{
+    foxdbg_recorder_close();
+}
+
+int foxdbg_start_playback(const char *path, double speed, bool loop)
+{
+    if (!foxdbg_playback_open(path, speed, loop))
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < foxdbg_playback_channel_count(); ++i)
+    {
+        int channel_id = foxdbg_add_channel(foxdbg_playback_channel_topic(i), FOXDBG_CHANNEL_TYPE_PLAYBACK, 1000);
+        foxdbg_playback_bind(i, channel_id);
+    }
+
+    foxdbg_playback_start();
+    foxdbg_thread_wake();
+
+    return 0;
+}
+
+int foxdbg_dump_recent(const char *path)
+{
+    return foxdbg_flight_dump(path) ? 0 : -1;
+}
+
+int foxdbg_set_rx_callback(int channel_id, foxdbg_rx_callback_t callback, void *user)
+{
+    foxdbg_channel_t *current = rx_channels;
+
+    while (current)
+    {
+        if (current->channel_id == channel_id)
+        {
+            current->rx_callback = callback;
+            current->rx_callback_user = user;
+
+            foxdbg_events_enable();
+
+            return 0;
+        }
+
+        current = current->next;
+    }
+
+    return -1; /* Channel not found */
+}
+
+void foxdbg_set_subscription_callback(foxdbg_subscription_callback_t callback, void *user)
+{
+    subscription_callback = callback;
+    subscription_callback_user = user;
+
+    foxdbg_events_enable();
+}
+
+void foxdbg_set_parameter_callback(foxdbg_parameter_callback_t callback, void *user)
+{
+    parameter_callback = callback;
+    parameter_callback_user = user;
+
+    foxdbg_events_enable();
+}
+
+void foxdbg_set_update_budget(uint64_t budget_us)
+{
+    ATOMIC_WRITE_U64(&update_budget_ns, budget_us * 1000);
+}
+
+int foxdbg_add_parameter(const char *name, foxdbg_parameter_type_t type, double value)
+{
+    return foxdbg_parameters_add(name, type, value);
+}
+
+int foxdbg_get_parameter(const char *name)
+{
+    return foxdbg_parameters_find(name);
+}
+
+double foxdbg_read_parameter(int parameter_id)
+{
+    return foxdbg_parameters_read(parameter_id);
+}
+
+int foxdbg_read_parameters(const int *parameter_ids, double *values, size_t count)
+{
+    return foxdbg_parameters_read_group(parameter_ids, values, count) ? 0 : -1;
+}
+
+int foxdbg_write_parameter(int parameter_id, double value)
+{
+    return foxdbg_parameters_write_group(&parameter_id, &value, 1) ? 0 : -1;
+}
+
+int foxdbg_intern_frame(const char *name)
+{
+    return foxdbg_frames_intern(name);
+}
+
+int foxdbg_encode_channel(int channel_id, size_t *encoded_size, uint64_t *encode_time_ns)
+{
+    foxdbg_channel_t *current = channels;
+
+    while (current)
+    {
+        if (current->channel_id == channel_id)
+        {
+            return foxdbg_thread_encode(current, encoded_size, encode_time_ns) ? 0 : -1;
+        }
+
+        current = current->next;
+    }
+
+    return -1; /* Channel not found */
+}
+
+int foxdbg_set_channel_option(int channel_id, foxdbg_channel_option_t option, double value)
+{
+    foxdbg_channel_t *current = channels;
+
+    while (current)
+    {
+        if (current->channel_id == channel_id)
+        {
+            switch (option)
+            {
+                case FOXDBG_CHANNEL_OPTION_JPEG_SLICES:
+                {
+                    if (current->channel_type != FOXDBG_CHANNEL_TYPE_IMAGE || value < 0.0)
+                    {
+                        return -1; /* Option does not apply */
+                    }
+
+                    current->jpeg_slices = (int)value;
+                } break;
+
+                case FOXDBG_CHANNEL_OPTION_SKIP_UNCHANGED:
+                {
+                    current->skip_unchanged = (value != 0.0);
+                } break;
+
+                case FOXDBG_CHANNEL_OPTION_KEEPALIVE_MS:
+                {
+                    if (value < 0.0)
+                    {
+                        return -1; /* Invalid value */
+                    }
+
+                    current->keepalive_time = (uint64_t)value;
+                } break;
+
+                case FOXDBG_CHANNEL_OPTION_VOXEL_SIZE:
+                {
+                    if (current->channel_type != FOXDBG_CHANNEL_TYPE_POINTCLOUD || value < 0.0)
+                    {
+                        return -1; /* Option does not apply */
+                    }
+
+                    current->voxel_size = (float)value;
+                } break;
+
+                case FOXDBG_CHANNEL_OPTION_POINT_BUDGET:
+                {
+                    if (current->channel_type != FOXDBG_CHANNEL_TYPE_POINTCLOUD || value < 0.0)
+                    {
+                        return -1; /* Option does not apply */
+                    }
+
+                    current->point_budget = (size_t)value;
+                } break;
+
+                case FOXDBG_CHANNEL_OPTION_QUANTIZE:
+                {
+                    if (current->channel_type != FOXDBG_CHANNEL_TYPE_POINTCLOUD)
+                    {
+                        return -1; /* Option does not apply */
+                    }
+
+                    current->quantize = (value != 0.0);
+                } break;
+
+                case FOXDBG_CHANNEL_OPTION_PATH_LENGTH:
+                {
+                    if (current->channel_type != FOXDBG_CHANNEL_TYPE_PATH || value < 1.0 || value > FOXDBG_PATH_MAX_LENGTH)
+                    {
+                        return -1; /* Option does not apply */
+                    }
+
+                    current->path_length = (size_t)value;
+                } break;
+
+                case FOXDBG_CHANNEL_OPTION_PATH_DISTANCE:
+                {
+                    if (current->channel_type != FOXDBG_CHANNEL_TYPE_PATH || value < 0.0)
+                    {
+                        return -1; /* Option does not apply */
+                    }
+
+                    current->path_distance = (float)value;
+                } break;
+
+                case FOXDBG_CHANNEL_OPTION_PATH_INTERVAL_MS:
+                {
+                    if (current->channel_type != FOXDBG_CHANNEL_TYPE_PATH || value < 0.0)
+                    {
+                        return -1; /* Option does not apply */
+                    }
+
+                    current->path_interval = (uint64_t)value;
+                } break;
+
+                case FOXDBG_CHANNEL_OPTION_TRANSFORM_DISTANCE:
+                {
+                    if (current->channel_type != FOXDBG_CHANNEL_TYPE_TRANSFORMS || value < 0.0)
+                    {
+                        return -1; /* Option does not apply */
+                    }
+
+                    current->transform_distance = (float)value;
+                } break;
+
+                case FOXDBG_CHANNEL_OPTION_TRANSFORM_ANGLE:
+                {
+                    if (current->channel_type != FOXDBG_CHANNEL_TYPE_TRANSFORMS || value < 0.0)
+                    {
+                        return -1; /* Option does not apply */
+                    }
+
+                    current->transform_angle = (float)value;
+                } break;
+
+                case FOXDBG_CHANNEL_OPTION_FLIGHT_QUOTA:
+                {
+                    if (value < 0.0)
+                    {
+                        return -1; /* Invalid value */
+                    }
+
+                    ATOMIC_WRITE_U64(&current->flight_quota, (uint64_t)value);
+
+                    /* without a client the server thread only polls for payloads when they are kept */
+                    foxdbg_thread_wake();
+                } break;
+
+                case FOXDBG_CHANNEL_OPTION_FLIGHT_RETENTION_MS:
+                {
+                    if (value < 0.0)
+                    {
+                        return -1; /* Invalid value */
+                    }
+
+                    ATOMIC_WRITE_U64(&current->flight_retention, (uint64_t)value);
+                } break;
+
+                default:
+                {
+                    return -1; /* Invalid option */
+                } break;
+            }
+
+            return 0;
+        }
+        current = current->next;
+    }
+
+    return -1; /* Channel not found */
+}
+
 /***************************************************************
 ** MARK: STATIC FUNCTIONS
 ***************************************************************/
+
+/* options and state at their defaults, the caller sets the topic, type, buffers, id and path history */
+static void init_channel_defaults(foxdbg_channel_t *channel)
+{
+    channel->subscription_id = -1;
+    channel->jpeg_slices = 0;
+    channel->skip_unchanged = false;
+    channel->keepalive_time = 1000;
+    channel->voxel_size = 0.0f;
+    channel->point_budget = 0;
+    channel->quantize = false;
+    channel->path_length = 1000;
+    channel->path_distance = 0.05f;
+    channel->path_interval = 0;
+    channel->transform_distance = 0.0f;
+    channel->transform_angle = 0.0f;
+    channel->flight_quota = 0;
+    channel->flight_retention = 30000;
+    channel->rx_latest = 0;
+    channel->rx_callback = NULL;
+    channel->rx_callback_user = NULL;
+    channel->last_sent_hash = 0;
+    channel->last_sent_time = 0;
+    channel->last_sent_subscription_id = -1;
+    memset(&channel->latency, 0, sizeof(channel->latency));
+    channel->write_count = 0;
+    channel->write_dropped = 0;
+    channel->send_count = 0;
+    channel->send_bytes = 0;
+    channel->send_dropped = 0;
+    memset(&channel->encode_time, 0, sizeof(channel->encode_time));
+    channel->protocol_state = NULL;
+    channel->recorder_state = NULL;
+    channel->recorded_write_time = 0;
+    channel->path_history = NULL;
+    channel->path_next = 0;
+    channel->path_count = 0;
+    channel->path_last_time = 0;
+    channel->next = NULL;
+}
+
+/* append pose to the history if it passes decimation, then publish history plus tip */
+static void write_path(foxdbg_channel_t *channel, const foxdbg_pose_t *pose, uint64_t timestamp, uint64_t now)
+{
+    uint64_t now_ms = now / 1000000ULL;
+
+    void *buffer_data = NULL;
+    size_t buffer_size = 0;
+
+    /* the write lock also guards the history, producers may share the channel */
+    foxdbg_buffer_begin_write(channel->data_buffer, &buffer_data, &buffer_size);
+
+    ATOMIC_WRITE_U64(&channel->write_count, ATOMIC_READ_U64(&channel->write_count) + 1);
+
+    bool kept = path_keep(channel, pose, now_ms);
+
+    if (kept)
+    {
+        channel->path_history[channel->path_next] = *pose;
+        channel->path_next = (channel->path_next + 1) % FOXDBG_PATH_MAX_LENGTH;
+        channel->path_last_time = now_ms;
+
+        if (channel->path_count < FOXDBG_PATH_MAX_LENGTH)
+        {
+            channel->path_count++;
+        }
+    }
+
+    if (!buffer_data)
+    {
+        foxdbg_buffer_end_write(channel->data_buffer, 0);
+        return;
+    }
+
+    size_t count = channel->path_count < channel->path_length ? channel->path_count : channel->path_length;
+    size_t first = (channel->path_next + FOXDBG_PATH_MAX_LENGTH - count) % FOXDBG_PATH_MAX_LENGTH;
+
+    /* oldest first, the ring wraps at most once */
+    size_t head = FOXDBG_PATH_MAX_LENGTH - first < count ? FOXDBG_PATH_MAX_LENGTH - first : count;
+    foxdbg_pose_t *out = (foxdbg_pose_t *)buffer_data;
+
+    memcpy(out, &channel->path_history[first], head * sizeof(foxdbg_pose_t));
+    memcpy(out + head, channel->path_history, (count - head) * sizeof(foxdbg_pose_t));
+
+    /* the newest pose is always drawn, even when decimation dropped it */
+    if (!kept)
+    {
+        out[count++] = *pose;
+    }
+
+    size_t size = count * sizeof(foxdbg_pose_t);
+
+    uint64_t hash = channel->skip_unchanged ? foxdbg_hash(buffer_data, size) : 0;
+    foxdbg_buffer_set_hash(channel->data_buffer, hash);
+    foxdbg_buffer_set_timestamp(channel->data_buffer, timestamp, now);
+
+    foxdbg_buffer_end_write(channel->data_buffer, size);
+}
+
+/* the caller's name pointers may not outlive the call, store interned ids instead */
+static void write_transform(foxdbg_channel_t *channel, const foxdbg_transform_t *transform, uint64_t timestamp, uint64_t now)
+{
+    foxdbg_frame_transform_t frame_transform;
+    memset(&frame_transform, 0, sizeof(frame_transform));
+
+    frame_transform.frame = foxdbg_frames_intern(transform->id);
+    frame_transform.parent = foxdbg_frames_intern(transform->parent_id);
+    frame_transform.position = transform->position;
+    frame_transform.orientation = transform->orientation;
+    frame_transform.is_static = false;
+
+    void *buffer_data = NULL;
+    size_t buffer_size = 0;
+
+    foxdbg_buffer_begin_write(channel->data_buffer, &buffer_data, &buffer_size);
+
+    ATOMIC_WRITE_U64(&channel->write_count, ATOMIC_READ_U64(&channel->write_count) + 1);
+
+    if (!buffer_data || frame_transform.frame < 0 || frame_transform.parent < 0)
+    {
+        foxdbg_buffer_set_hash(channel->data_buffer, 0);
+        foxdbg_buffer_set_timestamp(channel->data_buffer, timestamp, now);
+        foxdbg_buffer_end_write(channel->data_buffer, 0);
+        return;
+    }
+
+    memcpy(buffer_data, &frame_transform, sizeof(frame_transform));
+
+    uint64_t hash = channel->skip_unchanged ? foxdbg_hash(buffer_data, sizeof(frame_transform)) : 0;
+    foxdbg_buffer_set_hash(channel->data_buffer, hash);
+    foxdbg_buffer_set_timestamp(channel->data_buffer, timestamp, now);
+
+    foxdbg_buffer_end_write(channel->data_buffer, sizeof(frame_transform));
+}
+
+static bool path_keep(const foxdbg_channel_t *channel, const foxdbg_pose_t *pose, uint64_t now)
+{
+    if (channel->path_count == 0)
+    {
+        return true;
+    }
+
+    if (channel->path_distance <= 0.0f && channel->path_interval == 0)
+    {
+        return true; /* no decimation */
+    }
+
+    const foxdbg_pose_t *last = &channel->path_history[(channel->path_next + FOXDBG_PATH_MAX_LENGTH - 1) % FOXDBG_PATH_MAX_LENGTH];
+
+    float dx = pose->position.x - last->position.x;
+    float dy = pose->position.y - last->position.y;
+    float dz = pose->position.z - last->position.z;
+
+    if (channel->path_distance > 0.0f &&
+        dx * dx + dy * dy + dz * dz >= channel->path_distance * channel->path_distance)
+    {
+        return true;
+    }
+
+    return channel->path_interval > 0 && (now - channel->path_last_time) >= channel->path_interval;
+}
+
+static void dispatch_event(const foxdbg_event_t *event)
+{
+    switch (event->type)
+    {
+        case FOXDBG_EVENT_RX:
+        {
+            foxdbg_channel_t *current = rx_channels;
+
+            while (current && current->channel_id != event->id)
+            {
+                current = current->next;
+            }
+
+            if (current && current->rx_callback)
+            {
+                /* the value bits hold the channel's type in their first bytes */
+                uint32_t value = event->rx_value;
+                current->rx_callback(event->id, &value, current->data_buffer->buffer_size, current->rx_callback_user);
+            }
+        } break;
+
+        case FOXDBG_EVENT_SUBSCRIPTION:
+        {
+            if (subscription_callback)
+            {
+                subscription_callback(event->id, event->subscribed, subscription_callback_user);
+            }
+        } break;
+
+        case FOXDBG_EVENT_PARAMETER:
+        {
+            if (parameter_callback)
+            {
+                parameter_callback(event->id, event->parameter_value, parameter_callback_user);
+            }
+        } break;
+    }
+}
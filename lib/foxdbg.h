@@ -52,13 +52,24 @@ extern "C" {
 /* initialise the foxglove server */
 void foxdbg_init(void);
 
-/* poll for rx data callbacks */
+/*
+ * run the callbacks for client messages, subscription changes and
+ * parameter sets queued since the last call, for up to the update budget.
+ * call from one thread, e.g. once per control loop cycle
+ */
 void foxdbg_update(void);
 
+/* time one foxdbg_update call may spend in callbacks, 0 for no limit (default 1000 us) */
+void foxdbg_set_update_budget(uint64_t budget_us);
+
 /* shutdown the system */
 void foxdbg_shutdown(void);
 
-/* create a new channel */
+/*
+ * create a new channel, ids count up from 0 in the order channels are added.
+ * the server's counters are only published if FOXDBG_STATS_TOPIC is added
+ * as a FOXDBG_CHANNEL_TYPE_STATS channel, add it last to keep the other ids
+ */
 int foxdbg_add_channel(const char *topic_name, foxdbg_channel_type_t channel_type, int target_hz);
 
 int foxdbg_get_channel(const char *topic_name);
@@ -67,10 +78,82 @@ int foxdbg_add_rx_channel(const char *topic_name, foxdbg_channel_type_t channel_
 
 int foxdbg_get_rx_channel(const char *topic_name);
 
+/*
+ * copy the last value the client published to an rx channel into data,
+ * lock free, safe from the control loop. returns how many values have
+ * arrived (wrapping, never 0 once one has), 0 if none yet, -1 if the
+ * channel does not exist or size does not match its type
+ */
+int foxdbg_read_rx_channel(int channel_id, void *data, size_t size);
+
+/* called from foxdbg_update with each value the client publishes to an rx channel, NULL to stop. -1 if the channel does not exist */
+int foxdbg_set_rx_callback(int channel_id, foxdbg_rx_callback_t callback, void *user);
+
+/* called from foxdbg_update when the client subscribes to or unsubscribes from a channel */
+void foxdbg_set_subscription_callback(foxdbg_subscription_callback_t callback, void *user);
+
+/* called from foxdbg_update for each parameter the client sets, with its new value */
+void foxdbg_set_parameter_callback(foxdbg_parameter_callback_t callback, void *user);
+
+/* add a parameter the client can get, set and watch. -1 if the name is taken or the table is full */
+int foxdbg_add_parameter(const char *name, foxdbg_parameter_type_t type, double value);
+
+int foxdbg_get_parameter(const char *name);
+
+/* current value of a parameter, a single wait-free load for the control loop. 0 for unknown ids */
+double foxdbg_read_parameter(int parameter_id);
+
+/* values of several parameters, never a mix of two client updates. -1 for an unknown id */
+int foxdbg_read_parameters(const int *parameter_ids, double *values, size_t count);
+
+/* set a parameter from the application, subscribed clients are told. -1 for an unknown id */
+int foxdbg_write_parameter(int parameter_id, double value);
+
 void foxdbg_write_channel(int channel_id, const void *data, size_t size);
 
+/* as foxdbg_write_channel, stamped with the capture time (ns since epoch) instead of now. 0 means now */
+void foxdbg_write_channel_stamped(int channel_id, const void *data, size_t size, uint64_t timestamp);
+
 void foxdbg_write_channel_info(int channel_id, const void *data, size_t size);
 
+/* record every channel to an MCAP file at path, -1 if already recording or it cannot be created */
+int foxdbg_start_recording(const char *path);
+
+/* finish the MCAP file, anything still queued is written first */
+void foxdbg_stop_recording(void);
+
+/*
+ * serve an MCAP file instead of live channels, call after foxdbg_init.
+ * speed scales its log times (2.0 plays twice as fast), loop restarts at
+ * the end. -1 if the file cannot be read
+ */
+int foxdbg_start_playback(const char *path, double speed, bool loop);
+
+/*
+ * write the messages kept by FOXDBG_CHANNEL_OPTION_FLIGHT_QUOTA to an MCAP
+ * file at path in the background. callable from any thread, -1 if nothing
+ * is kept
+ */
+int foxdbg_dump_recent(const char *path);
+
+/* small integer id for a frame name, for foxdbg_frame_transform_t. -1 if the table is full */
+int foxdbg_intern_frame(const char *name);
+
+/* copy of a channel's write to send latency histogram, -1 if the channel does not exist */
+int foxdbg_get_channel_latency(int channel_id, foxdbg_latency_t *latency);
+
+/*
+ * encode a channel's latest payload as it would be sent and throw it away,
+ * for benchmarks. runs on the server thread and blocks until it is done,
+ * encode_time_ns (may be NULL) is the time it took there, without the
+ * hand-off. -1 if the channel does not exist, the server has not started
+ * yet, or a client is connected, recording or flight data is being kept
+ */
+int foxdbg_encode_channel(int channel_id, size_t *encoded_size, uint64_t *encode_time_ns);
+
+/* tune how the server encodes a channel, call after foxdbg_add_channel */
+int foxdbg_set_channel_option(int channel_id, foxdbg_channel_option_t option, double value);
+
 
 #ifdef __cplusplus
 }
@@ -18,6 +18,7 @@
 ** MARK: INCLUDES
 ***************************************************************/
 
+#include <stdint.h>
 
 #if defined(_MSC_VER)
     #define WIN32_LEAN_AND_MEAN
@@ -39,10 +40,14 @@
     #define YIELD_CPU() Sleep(0)
     #define ATOMIC_READ_INT(ptr) (_mm_mfence(), InterlockedCompareExchange((volatile LONG *)(ptr), 0, 0))
     #define ATOMIC_WRITE_INT(ptr, val) (_mm_mfence(), InterlockedExchange((volatile LONG *)(ptr), (val)), _mm_mfence())
+    #define ATOMIC_READ_U64(ptr) ((uint64_t)InterlockedCompareExchange64((volatile LONG64 *)(ptr), 0, 0))
+    #define ATOMIC_WRITE_U64(ptr, val) (InterlockedExchange64((volatile LONG64 *)(ptr), (LONG64)(val)))
 #elif defined(__GNUC__) || defined(__clang__)
     #define YIELD_CPU() sched_yield()
     #define ATOMIC_READ_INT(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
     #define ATOMIC_WRITE_INT(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_SEQ_CST)
+    #define ATOMIC_READ_U64(ptr) __atomic_load_n((uint64_t *)(ptr), __ATOMIC_SEQ_CST)
+    #define ATOMIC_WRITE_U64(ptr, val) __atomic_store_n((uint64_t *)(ptr), (uint64_t)(val), __ATOMIC_SEQ_CST)
 #else
     #error "Unsupported compiler - implement atomic operations for your compiler"
 #endif
@@ -88,6 +88,12 @@ bool foxdbg_buffer_alloc(size_t size, foxdbg_buffer_t **buffer)
     buf->back_buffer = buf->buffer_b;
     buf->front_buffer_size = 0;
     buf->back_buffer_size = 0;
+    buf->front_buffer_hash = 0;
+    buf->back_buffer_hash = 0;
+    buf->front_buffer_timestamp = 0;
+    buf->back_buffer_timestamp = 0;
+    buf->front_buffer_write_time = 0;
+    buf->back_buffer_write_time = 0;
 
 #ifdef _WIN32
     buf->write_mutex = CreateMutex(NULL, FALSE, NULL);
@@ -214,6 +220,32 @@ void foxdbg_buffer_end_read(foxdbg_buffer_t* buffer)
 #endif
 }
 
+void foxdbg_buffer_set_hash(foxdbg_buffer_t* buffer, uint64_t hash)
+{
+    buffer->back_buffer_hash = hash;
+}
+
+uint64_t foxdbg_buffer_get_hash(foxdbg_buffer_t* buffer)
+{
+    return buffer->front_buffer_hash;
+}
+
+void foxdbg_buffer_set_timestamp(foxdbg_buffer_t* buffer, uint64_t timestamp, uint64_t write_time)
+{
+    buffer->back_buffer_timestamp = timestamp;
+    buffer->back_buffer_write_time = write_time;
+}
+
+uint64_t foxdbg_buffer_get_timestamp(foxdbg_buffer_t* buffer)
+{
+    return buffer->front_buffer_timestamp;
+}
+
+uint64_t foxdbg_buffer_get_write_time(foxdbg_buffer_t* buffer)
+{
+    return buffer->front_buffer_write_time;
+}
+
 /***************************************************************
 ** MARK: STATIC FUNCTIONS
 ***************************************************************/
@@ -247,6 +279,18 @@ static void swap_buffers(foxdbg_buffer_t* buffer)
     buffer->front_buffer_size = buffer->back_buffer_size;
     buffer->back_buffer_size = tmp_size;
 
+    uint64_t tmp_hash = buffer->front_buffer_hash;
+    buffer->front_buffer_hash = buffer->back_buffer_hash;
+    buffer->back_buffer_hash = tmp_hash;
+
+    uint64_t tmp_timestamp = buffer->front_buffer_timestamp;
+    buffer->front_buffer_timestamp = buffer->back_buffer_timestamp;
+    buffer->back_buffer_timestamp = tmp_timestamp;
+
+    uint64_t tmp_write_time = buffer->front_buffer_write_time;
+    buffer->front_buffer_write_time = buffer->back_buffer_write_time;
+    buffer->back_buffer_write_time = tmp_write_time;
+
 #ifdef _WIN32
     // Release all locks in reverse order
     ReleaseMutex(buffer->write_mutex);
@@ -48,6 +48,14 @@ typedef struct
     void* back_buffer;
     size_t back_buffer_size;    /* populated size */
 
+    uint64_t front_buffer_hash; /* content hash, 0 if not computed */
+    uint64_t back_buffer_hash;
+
+    uint64_t front_buffer_timestamp;    /* capture time, ns since epoch */
+    uint64_t back_buffer_timestamp;
+    uint64_t front_buffer_write_time;   /* when the payload was written, ns since epoch */
+    uint64_t back_buffer_write_time;
+
 #ifdef _WIN32
     void* write_mutex;
     void* read_mutex;
@@ -76,6 +84,13 @@ void foxdbg_buffer_end_write(foxdbg_buffer_t* buffer, size_t populated_size);
 void foxdbg_buffer_begin_read(foxdbg_buffer_t* buffer, void **data, size_t *size); /* size here is populated size (i.e available for reading )*/
 void foxdbg_buffer_end_read(foxdbg_buffer_t* buffer);
 
+void foxdbg_buffer_set_hash(foxdbg_buffer_t* buffer, uint64_t hash); /* call between begin_write and end_write */
+uint64_t foxdbg_buffer_get_hash(foxdbg_buffer_t* buffer); /* call between begin_read and end_read */
+
+void foxdbg_buffer_set_timestamp(foxdbg_buffer_t* buffer, uint64_t timestamp, uint64_t write_time); /* call between begin_write and end_write */
+uint64_t foxdbg_buffer_get_timestamp(foxdbg_buffer_t* buffer); /* call between begin_read and end_read */
+uint64_t foxdbg_buffer_get_write_time(foxdbg_buffer_t* buffer); /* call between begin_read and end_read */
+
 #ifdef __cplusplus
 }
 #endif
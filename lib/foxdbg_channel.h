@@ -32,6 +32,25 @@
 
 #define LARGE_BUFFER_SIZE (10*1024*1024) /* 1MB buffer */
 
+#define FOXDBG_POINTCLOUD_MAX_FIELDS (16U)
+#define FOXDBG_FIELD_NAME_LENGTH (32U)
+#define FOXDBG_FRAME_ID_LENGTH (64U)
+#define FOXDBG_MAX_FRAMES (256U)
+#define FOXDBG_TEXT_LENGTH (64U)
+
+/* bucket i counts durations (write to send delay, encode time) of [2^i, 2^(i+1)) us, bucket 0 anything below 2 us */
+#define FOXDBG_LATENCY_BUCKETS (24U)
+
+/* poses a path channel can hold, the tip is sent on top of these */
+#define FOXDBG_PATH_MAX_LENGTH (4096U)
+
+#define FOXDBG_MAX_PARAMETERS (256U)
+#define FOXDBG_PARAMETER_NAME_LENGTH (64U)
+
+/* optional channel reporting the counters of every other channel */
+#define FOXDBG_STATS_TOPIC "/foxdbg/stats"
+#define FOXDBG_STATS_HZ (1)
+
 /***************************************************************
 ** MARK: TYPEDEFS
 ***************************************************************/
@@ -82,6 +101,16 @@ typedef struct
     foxdbg_vector3_t orientation;
 } foxdbg_transform_t;
 
+/* transform between two frames from foxdbg_intern_frame */
+typedef struct
+{
+    int frame;
+    int parent;
+    foxdbg_vector3_t position;
+    foxdbg_vector3_t orientation;
+    bool is_static;                     /* never changes, not checked for movement, sent once per subscription and every keepalive */
+} foxdbg_frame_transform_t;
+
 typedef struct
 {
     foxdbg_vector3_t start;
@@ -90,6 +119,36 @@ typedef struct
     float thickness;
 } foxdbg_line_t;
 
+typedef struct
+{
+    foxdbg_vector3_t position;
+    foxdbg_vector3_t size;              /* diameter along each axis */
+    foxdbg_color_t color;
+} foxdbg_sphere_t;
+
+typedef struct
+{
+    foxdbg_vector3_t position;          /* tail of the arrow */
+    foxdbg_vector3_t orientation;
+    float length;                       /* tip to tail */
+    float diameter;                     /* shaft diameter, the head is twice as wide */
+    foxdbg_color_t color;
+} foxdbg_arrow_t;
+
+typedef struct
+{
+    foxdbg_vector3_t vertices[3];
+    foxdbg_color_t colors[3];           /* per vertex, blended across the face */
+} foxdbg_triangle_t;
+
+typedef struct
+{
+    foxdbg_vector3_t position;
+    float font_size;                    /* in pixels, always faces the camera */
+    foxdbg_color_t color;
+    char text[FOXDBG_TEXT_LENGTH];      /* null terminated */
+} foxdbg_text_t;
+
 typedef struct
 {
     uint32_t timestamp_sec;
@@ -110,16 +169,141 @@ typedef enum
     FOXDBG_CHANNEL_TYPE_LOCATION,
     FOXDBG_CHANNEL_TYPE_FLOAT,
     FOXDBG_CHANNEL_TYPE_INTEGER,
-    FOXDBG_CHANNEL_TYPE_BOOLEAN
+    FOXDBG_CHANNEL_TYPE_BOOLEAN,
+    FOXDBG_CHANNEL_TYPE_SCENE,
+    FOXDBG_CHANNEL_TYPE_SPHERES,
+    FOXDBG_CHANNEL_TYPE_ARROWS,
+    FOXDBG_CHANNEL_TYPE_TRIANGLES,
+    FOXDBG_CHANNEL_TYPE_TEXT,
+    FOXDBG_CHANNEL_TYPE_POSES,
+    FOXDBG_CHANNEL_TYPE_PATH,
+    FOXDBG_CHANNEL_TYPE_TRANSFORMS,
+    FOXDBG_CHANNEL_TYPE_PLAYBACK,       /* a channel of an MCAP file served by foxdbg_start_playback */
+    FOXDBG_CHANNEL_TYPE_STATS           /* FOXDBG_STATS_TOPIC, filled in by the server */
 } foxdbg_channel_type_t;
 
+typedef enum
+{
+    FOXDBG_SCENE_PRIMITIVE_CUBE,
+    FOXDBG_SCENE_PRIMITIVE_LINE,
+    FOXDBG_SCENE_PRIMITIVE_ARROW
+} foxdbg_scene_primitive_t;
+
+/*
+ * one entity of a scene channel. write the whole current set of entities
+ * each time, the server only sends the ones that changed and deletes the
+ * ones that are gone.
+ */
+typedef struct
+{
+    uint32_t id;                        /* stable, unique within the channel */
+    float lifetime;                     /* seconds shown after its last change, 0 until removed */
+    foxdbg_scene_primitive_t type;
+
+    union
+    {
+        foxdbg_cube_t cube;
+        foxdbg_line_t line;
+        foxdbg_pose_t arrow;
+    } primitive;
+} foxdbg_scene_entity_t;
+
+typedef enum
+{
+    FOXDBG_PIXEL_FORMAT_AUTO,       /* derived from channels: 1 gray, 3 rgb, 4 rgba, as is any unknown value */
+    FOXDBG_PIXEL_FORMAT_GRAY,
+    FOXDBG_PIXEL_FORMAT_RGB,
+    FOXDBG_PIXEL_FORMAT_RGBA,
+    FOXDBG_PIXEL_FORMAT_BGR,
+    FOXDBG_PIXEL_FORMAT_BGRA,
+    FOXDBG_PIXEL_FORMAT_BGRX,
+    FOXDBG_PIXEL_FORMAT_I420,       /* planar Y, U, V with 2x2 subsampled chroma */
+    FOXDBG_PIXEL_FORMAT_NV12,       /* planar Y followed by interleaved UV */
+    FOXDBG_PIXEL_FORMAT_BAYER_RGGB, /* raw 8-bit sensor mosaic */
+    FOXDBG_PIXEL_FORMAT_JPEG,       /* pre-compressed bitstream, forwarded as-is */
+    FOXDBG_PIXEL_FORMAT_PNG         /* pre-compressed bitstream, forwarded as-is */
+} foxdbg_pixel_format_t;
+
 typedef struct
 {
     int width;
     int height;
     int channels;
+    foxdbg_pixel_format_t format;
 } foxdbg_image_info_t;
 
+/* values match foxglove.NumericType */
+typedef enum
+{
+    FOXDBG_FIELD_TYPE_UINT8 = 1,
+    FOXDBG_FIELD_TYPE_INT8 = 2,
+    FOXDBG_FIELD_TYPE_UINT16 = 3,
+    FOXDBG_FIELD_TYPE_INT16 = 4,
+    FOXDBG_FIELD_TYPE_UINT32 = 5,
+    FOXDBG_FIELD_TYPE_INT32 = 6,
+    FOXDBG_FIELD_TYPE_FLOAT32 = 7,
+    FOXDBG_FIELD_TYPE_FLOAT64 = 8
+} foxdbg_field_type_t;
+
+typedef struct
+{
+    char name[FOXDBG_FIELD_NAME_LENGTH];
+    uint32_t offset;                    /* byte offset within a point */
+    foxdbg_field_type_t type;
+} foxdbg_pointcloud_field_t;
+
+/*
+ * layout of the packed points written to a point cloud channel. without
+ * one the channel expects foxdbg_vector4_t points (x, y, z, intensity).
+ */
+typedef struct
+{
+    uint32_t point_stride;
+    uint32_t field_count;
+    foxdbg_pointcloud_field_t fields[FOXDBG_POINTCLOUD_MAX_FIELDS];
+
+    char frame_id[FOXDBG_FRAME_ID_LENGTH];
+    foxdbg_vector3_t position;          /* origin of the cloud in frame_id */
+    foxdbg_vector3_t orientation;
+} foxdbg_pointcloud_info_t;
+
+typedef enum
+{
+    FOXDBG_CHANNEL_OPTION_JPEG_SLICES,    /* max strips a large image is split into for parallel encoding, 0 disables */
+    FOXDBG_CHANNEL_OPTION_SKIP_UNCHANGED, /* non-zero hashes each write and skips encoding/sending identical payloads */
+    FOXDBG_CHANNEL_OPTION_KEEPALIVE_MS,   /* resend period for unchanged payloads, 0 never resends (default 1000) */
+    FOXDBG_CHANNEL_OPTION_VOXEL_SIZE,     /* vector4 point clouds: average points into voxels of this edge length (m), 0 disables */
+    FOXDBG_CHANNEL_OPTION_POINT_BUDGET,   /* vector4 point clouds: coarsen the voxel grid until at most this many points remain, 0 disables */
+    FOXDBG_CHANNEL_OPTION_QUANTIZE,       /* vector4 point clouds: non-zero sends ~1 mm positions and uint8 intensity */
+    FOXDBG_CHANNEL_OPTION_PATH_LENGTH,    /* paths: poses of history kept, up to FOXDBG_PATH_MAX_LENGTH (default 1000) */
+    FOXDBG_CHANNEL_OPTION_PATH_DISTANCE,  /* paths: keep a pose once it is this far (m) from the last kept one, 0 disables (default 0.05) */
+    FOXDBG_CHANNEL_OPTION_PATH_INTERVAL_MS, /* paths: keep a pose once this long after the last kept one, 0 disables */
+    FOXDBG_CHANNEL_OPTION_TRANSFORM_DISTANCE, /* transforms: resend a dynamic transform once it moves this far (m), 0 on any change */
+    FOXDBG_CHANNEL_OPTION_TRANSFORM_ANGLE,   /* transforms: resend a dynamic transform once it turns this far (rad), 0 on any change */
+    FOXDBG_CHANNEL_OPTION_FLIGHT_QUOTA,      /* bytes of encoded messages kept in RAM for foxdbg_dump_recent, 0 disables (default) */
+    FOXDBG_CHANNEL_OPTION_FLIGHT_RETENTION_MS /* age of the oldest message kept for foxdbg_dump_recent (default 30000) */
+} foxdbg_channel_option_t;
+
+typedef enum
+{
+    FOXDBG_PARAMETER_TYPE_FLOAT,    /* double */
+    FOXDBG_PARAMETER_TYPE_INTEGER,  /* whole numbers up to 2^53 */
+    FOXDBG_PARAMETER_TYPE_BOOLEAN   /* 0 or 1 */
+} foxdbg_parameter_type_t;
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t total_us;
+    uint64_t max_us;
+    uint64_t buckets[FOXDBG_LATENCY_BUCKETS];
+} foxdbg_latency_t;
+
+/* callbacks run by foxdbg_update on the thread calling it */
+typedef void (*foxdbg_rx_callback_t)(int channel_id, const void *data, size_t size, void *user);
+typedef void (*foxdbg_subscription_callback_t)(int channel_id, bool subscribed, void *user);
+typedef void (*foxdbg_parameter_callback_t)(int parameter_id, double value, void *user);
+
 typedef struct foxdbg_channel_t
 {
     const char *topic_name;
@@ -134,6 +318,59 @@ typedef struct foxdbg_channel_t
     foxdbg_buffer_t *data_buffer;
     foxdbg_buffer_t *info_buffer;
 
+    /* options, see foxdbg_channel_option_t */
+    int jpeg_slices;
+    bool skip_unchanged;
+    uint64_t keepalive_time;
+    float voxel_size;
+    size_t point_budget;
+    bool quantize;
+    size_t path_length;
+    float path_distance;
+    uint64_t path_interval;
+    float transform_distance;
+    float transform_angle;
+
+    /* last payload handed to the client, used by skip_unchanged */
+    uint64_t last_sent_hash;
+    uint64_t last_sent_time;
+    int last_sent_subscription_id;
+
+    /* write to send delay of every message sent, updated by the server thread */
+    foxdbg_latency_t latency;
+
+    /* counters for FOXDBG_STATS_TOPIC, read without locks, the producers' ones atomically */
+    uint64_t write_count;               /* payloads written, by the producers under the buffer lock */
+    uint64_t write_dropped;             /* payloads larger than the buffer, likewise */
+    uint64_t send_count;                /* messages written to the client, by the server thread */
+    uint64_t send_bytes;
+    uint64_t send_dropped;              /* payloads too large to encode or send, likewise */
+    foxdbg_latency_t encode_time;       /* time to build and send each payload to the client */
+
+    /* what the client currently holds (scene entities, transforms), owned by the protocol */
+    void *protocol_state;
+
+    /* the same for the recording, and the write time of the last payload recorded */
+    void *recorder_state;
+    uint64_t recorded_write_time;
+
+    /* in-memory ring of recent messages for foxdbg_dump_recent, set by the user thread, accessed atomically */
+    uint64_t flight_quota;
+    uint64_t flight_retention;
+
+    /* rx channels: last value received from the client, sequence << 32 | value bits, accessed atomically */
+    uint64_t rx_latest;
+
+    /* rx channels: called from foxdbg_update with each value received */
+    foxdbg_rx_callback_t rx_callback;
+    void *rx_callback_user;
+
+    /* decimated pose history of a path channel, written by the producer */
+    foxdbg_pose_t *path_history;
+    size_t path_next;
+    size_t path_count;
+    uint64_t path_last_time;
+
     struct foxdbg_channel_t *next;
 } foxdbg_channel_t;
 
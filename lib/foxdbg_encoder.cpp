@@ -0,0 +1,562 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_encoder.cpp
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server JPEG Encoder
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_encoder.h"
+#include "foxdbg_image.h"
+#include "foxdbg_thread.h"
+
+#include <string.h>
+#include <stdio.h>
+
+#include <turbojpeg.h>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+#define JPEG_MARKER_SOF0 (0xC0U)
+#define JPEG_MARKER_SOF1 (0xC1U)
+#define JPEG_MARKER_SOS  (0xDAU)
+#define JPEG_MARKER_RST0 (0xD0U)
+#define JPEG_MARKER_EOI  (0xD9U)
+#define JPEG_MARKER_DRI  (0xDDU)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+typedef struct
+{
+    bool planar;
+
+    /* planar (I420) source */
+    const unsigned char *planes[3];
+
+    /* packed source */
+    const unsigned char *pixels;
+    int pixel_format;
+    int pitch;
+
+    int width;
+    int height;
+    int subsamp;
+} image_source_t;
+
+/* per worker TurboJPEG state, only ever touched by its own worker */
+typedef struct
+{
+    tjhandle handle;
+
+    unsigned char *output;          /* reused through TJFLAG_NOREALLOC */
+    unsigned long output_capacity;
+} encoder_context_t;
+
+typedef struct
+{
+    const image_source_t *source;
+    int slice_rows;
+
+    unsigned char *jpeg[FOXDBG_MAX_JPEG_SLICES];            /* persistent, grown on demand */
+    unsigned long jpeg_capacity[FOXDBG_MAX_JPEG_SLICES];
+    unsigned long jpeg_size[FOXDBG_MAX_JPEG_SLICES];
+    bool ok[FOXDBG_MAX_JPEG_SLICES];
+} slice_job_t;
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static bool prepare_source(const foxdbg_image_info_t *info, const uint8_t *pixels, size_t pixels_size, image_source_t *source);
+
+static bool reserve_output(unsigned char **buffer, unsigned long *capacity, unsigned long required);
+
+static bool compress_rows(tjhandle handle, const image_source_t *source, int first_row, int rows, unsigned char *jpeg, unsigned long *jpeg_size);
+
+static bool compress_single(const image_source_t *source, const unsigned char **jpeg, size_t *jpeg_size);
+static bool compress_slices(const image_source_t *source, int max_slices, const unsigned char **jpeg, size_t *jpeg_size);
+static void compress_slice_task(void *context, size_t task_index, size_t worker_index);
+
+static bool find_scan(const unsigned char *jpeg, unsigned long jpeg_size, size_t *sof_offset, size_t *sos_offset, size_t *data_offset);
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+static encoder_context_t encoders[FOXDBG_MAX_ENCODER_THREADS + 1];
+static size_t encoder_count = 0;
+
+static uint8_t plane_buffer[15*1024*1024]; /* I420 planes for NV12 and Bayer frames */
+
+static slice_job_t slice_job;
+
+static int jpegSubsamp = TJSAMP_420; /* Default to 4:2:0 subsampling */
+static int jpegQuality = 25; /* Default quality factor */
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+bool foxdbg_encoder_init(size_t worker_count)
+{
+    if (worker_count > FOXDBG_MAX_ENCODER_THREADS + 1)
+    {
+        worker_count = FOXDBG_MAX_ENCODER_THREADS + 1;
+    }
+
+    for (size_t i = 0; i < worker_count; ++i)
+    {
+        encoders[i].handle = tjInitCompress();
+        encoders[i].output = NULL;
+        encoders[i].output_capacity = 0;
+
+        if (encoders[i].handle == NULL)
+        {
+            fprintf(stderr, "Failed to initialize JPEG compressor: %s\n", tjGetErrorStr());
+            foxdbg_encoder_shutdown();
+            return false;
+        }
+
+        encoder_count = i + 1;
+    }
+
+    return true;
+}
+
+void foxdbg_encoder_shutdown(void)
+{
+    for (size_t i = 0; i < encoder_count; ++i)
+    {
+        tjDestroy(encoders[i].handle);
+        tjFree(encoders[i].output);
+
+        encoders[i].handle = NULL;
+        encoders[i].output = NULL;
+        encoders[i].output_capacity = 0;
+    }
+
+    encoder_count = 0;
+
+    for (size_t i = 0; i < FOXDBG_MAX_JPEG_SLICES; ++i)
+    {
+        tjFree(slice_job.jpeg[i]);
+
+        slice_job.jpeg[i] = NULL;
+        slice_job.jpeg_capacity[i] = 0;
+    }
+}
+
+bool foxdbg_encoder_compress(const foxdbg_image_info_t *info, const uint8_t *pixels, size_t pixels_size, int max_slices, const unsigned char **jpeg, size_t *jpeg_size)
+{
+    if (encoder_count == 0)
+    {
+        return false;
+    }
+
+    image_source_t source;
+
+    if (!prepare_source(info, pixels, pixels_size, &source))
+    {
+        return false;
+    }
+
+    size_t pixel_count = (size_t)source.width * (size_t)source.height;
+
+    if (max_slices > 1 && encoder_count > 1 && pixel_count >= FOXDBG_JPEG_SLICE_MIN_PIXELS)
+    {
+        return compress_slices(&source, max_slices, jpeg, jpeg_size);
+    }
+
+    return compress_single(&source, jpeg, jpeg_size);
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+static bool prepare_source(const foxdbg_image_info_t *info, const uint8_t *pixels, size_t pixels_size, image_source_t *source)
+{
+    foxdbg_pixel_format_t format = foxdbg_image_pixel_format(info);
+
+    size_t frame_size = foxdbg_image_frame_size(format, info->width, info->height);
+
+    if (frame_size == 0 || pixels_size < frame_size)
+    {
+        fprintf(stderr, "Image buffer does not match image info\n");
+        return false;
+    }
+
+    memset(source, 0, sizeof(*source));
+    source->width = info->width;
+    source->height = info->height;
+
+    switch (format)
+    {
+        case FOXDBG_PIXEL_FORMAT_I420:
+        case FOXDBG_PIXEL_FORMAT_NV12:
+        case FOXDBG_PIXEL_FORMAT_BAYER_RGGB:
+        {
+            size_t luma_size = (size_t)info->width * info->height;
+            size_t chroma_size = (size_t)((info->width + 1) / 2) * ((info->height + 1) / 2);
+
+            source->planar = true;
+            source->subsamp = TJSAMP_420;
+
+            if (format == FOXDBG_PIXEL_FORMAT_I420)
+            {
+                /* already planar, hand the planes straight to the encoder */
+                source->planes[0] = pixels;
+                source->planes[1] = pixels + luma_size;
+                source->planes[2] = pixels + luma_size + chroma_size;
+            }
+            else if (format == FOXDBG_PIXEL_FORMAT_NV12)
+            {
+                if (2 * chroma_size > sizeof(plane_buffer))
+                {
+                    fprintf(stderr, "Unsupported NV12 image size\n");
+                    return false;
+                }
+
+                /* luma is used in place, only the interleaved chroma is split */
+                foxdbg_image_deinterleave_uv(pixels + luma_size, plane_buffer, plane_buffer + chroma_size, chroma_size);
+
+                source->planes[0] = pixels;
+                source->planes[1] = plane_buffer;
+                source->planes[2] = plane_buffer + chroma_size;
+            }
+            else
+            {
+                if (luma_size + 2 * chroma_size > sizeof(plane_buffer) ||
+                    !foxdbg_image_bayer_rggb_to_i420(pixels, info->width, info->height,
+                        plane_buffer, plane_buffer + luma_size, plane_buffer + luma_size + chroma_size))
+                {
+                    fprintf(stderr, "Unsupported Bayer image size\n");
+                    return false;
+                }
+
+                source->planes[0] = plane_buffer;
+                source->planes[1] = plane_buffer + luma_size;
+                source->planes[2] = plane_buffer + luma_size + chroma_size;
+            }
+        } break;
+
+        default:
+        {
+            switch (format)
+            {
+                case FOXDBG_PIXEL_FORMAT_GRAY: source->pixel_format = TJPF_GRAY; break;
+                case FOXDBG_PIXEL_FORMAT_RGBA: source->pixel_format = TJPF_RGBA; break;
+                case FOXDBG_PIXEL_FORMAT_BGR:  source->pixel_format = TJPF_BGR;  break;
+                case FOXDBG_PIXEL_FORMAT_BGRA: source->pixel_format = TJPF_BGRA; break;
+                case FOXDBG_PIXEL_FORMAT_BGRX: source->pixel_format = TJPF_BGRX; break;
+                default:                       source->pixel_format = TJPF_RGB;  break;
+            }
+
+            source->planar = false;
+            source->pixels = pixels;
+            source->pitch = info->width * tjPixelSize[source->pixel_format];
+            source->subsamp = (source->pixel_format == TJPF_GRAY) ? TJSAMP_GRAY : jpegSubsamp;
+        } break;
+    }
+
+    return true;
+}
+
+static bool reserve_output(unsigned char **buffer, unsigned long *capacity, unsigned long required)
+{
+    /* only grows when a frame larger than any before arrives */
+    if (*buffer && *capacity >= required)
+    {
+        return true;
+    }
+
+    tjFree(*buffer);
+
+    *buffer = tjAlloc((int)required);
+    *capacity = *buffer ? required : 0;
+
+    if (!*buffer)
+    {
+        fprintf(stderr, "Failed to allocate JPEG output buffer\n");
+        return false;
+    }
+
+    return true;
+}
+
+static bool compress_rows(tjhandle handle, const image_source_t *source, int first_row, int rows, unsigned char *jpeg, unsigned long *jpeg_size)
+{
+    int result;
+
+    /* jpeg is at least tjBufSize() for these rows, so TurboJPEG never reallocates it */
+    if (source->planar)
+    {
+        /* first_row is always a multiple of the MCU height, so chroma rows halve cleanly */
+        int chroma_width = (source->width + 1) / 2;
+        int strides[3] = { source->width, chroma_width, chroma_width };
+
+        const unsigned char *planes[3] = {
+            source->planes[0] + (size_t)first_row * strides[0],
+            source->planes[1] + (size_t)(first_row / 2) * strides[1],
+            source->planes[2] + (size_t)(first_row / 2) * strides[2]
+        };
+
+        result = tjCompressFromYUVPlanes(
+            handle,
+            planes,
+            source->width,
+            strides,
+            rows,
+            source->subsamp,
+            &jpeg,
+            jpeg_size,
+            jpegQuality,
+            TJFLAG_FASTDCT | TJFLAG_NOREALLOC
+        );
+    }
+    else
+    {
+        result = tjCompress2(
+            handle,
+            source->pixels + (size_t)first_row * source->pitch,
+            source->width,
+            source->pitch,
+            rows,
+            source->pixel_format,
+            &jpeg,
+            jpeg_size,
+            source->subsamp,
+            jpegQuality,
+            TJFLAG_FASTDCT | TJFLAG_NOREALLOC
+        );
+    }
+
+    if (result != 0)
+    {
+        fprintf(stderr, "Failed to compress image: %s\n", tjGetErrorStr2(handle));
+        return false;
+    }
+
+    return true;
+}
+
+static bool compress_single(const image_source_t *source, const unsigned char **jpeg, size_t *jpeg_size)
+{
+    encoder_context_t *encoder = &encoders[0];
+
+    if (!reserve_output(&encoder->output, &encoder->output_capacity, tjBufSize(source->width, source->height, source->subsamp)))
+    {
+        return false;
+    }
+
+    unsigned long size = 0;
+
+    if (!compress_rows(encoder->handle, source, 0, source->height, encoder->output, &size))
+    {
+        return false;
+    }
+
+    *jpeg = encoder->output;
+    *jpeg_size = (size_t)size;
+
+    return true;
+}
+
+static bool compress_slices(const image_source_t *source, int max_slices, const unsigned char **jpeg, size_t *jpeg_size)
+{
+    int mcu_width = tjMCUWidth[source->subsamp];
+    int mcu_height = tjMCUHeight[source->subsamp];
+
+    int mcu_cols = (source->width + mcu_width - 1) / mcu_width;
+    int mcu_rows = (source->height + mcu_height - 1) / mcu_height;
+
+    if (max_slices > (int)FOXDBG_MAX_JPEG_SLICES)
+    {
+        max_slices = FOXDBG_MAX_JPEG_SLICES;
+    }
+
+    /* every strip but the last spans the same number of MCU rows, that is the restart interval */
+    int slice_mcu_rows = (mcu_rows + max_slices - 1) / max_slices;
+    int max_slice_mcu_rows = 0xFFFF / mcu_cols;
+
+    if (max_slice_mcu_rows < 1)
+    {
+        return compress_single(source, jpeg, jpeg_size);
+    }
+
+    if (slice_mcu_rows > max_slice_mcu_rows)
+    {
+        slice_mcu_rows = max_slice_mcu_rows;
+    }
+
+    int slice_count = (mcu_rows + slice_mcu_rows - 1) / slice_mcu_rows;
+
+    if (slice_count <= 1 || slice_count > (int)FOXDBG_MAX_JPEG_SLICES)
+    {
+        return compress_single(source, jpeg, jpeg_size);
+    }
+
+    slice_job_t *job = &slice_job;
+
+    job->source = source;
+    job->slice_rows = slice_mcu_rows * mcu_height;
+
+    unsigned long slice_capacity = tjBufSize(source->width, job->slice_rows, source->subsamp);
+
+    for (int i = 0; i < slice_count; ++i)
+    {
+        if (!reserve_output(&job->jpeg[i], &job->jpeg_capacity[i], slice_capacity))
+        {
+            return false;
+        }
+
+        job->jpeg_size[i] = 0;
+        job->ok[i] = false;
+    }
+
+    foxdbg_thread_parallel(compress_slice_task, job, (size_t)slice_count);
+
+    size_t sof_offset = 0;
+    size_t sos_offset = 0;
+    size_t data_offset[FOXDBG_MAX_JPEG_SLICES];
+    size_t total_size = 6; /* DRI segment */
+
+    for (int i = 0; i < slice_count; ++i)
+    {
+        size_t slice_sof, slice_sos;
+
+        if (!job->ok[i] || !find_scan(job->jpeg[i], job->jpeg_size[i], &slice_sof, &slice_sos, &data_offset[i]))
+        {
+            fprintf(stderr, "Failed to stitch JPEG slices\n");
+            return false;
+        }
+
+        if (i == 0)
+        {
+            sof_offset = slice_sof;
+            sos_offset = slice_sos;
+            total_size += data_offset[0];
+        }
+
+        total_size += (job->jpeg_size[i] - 2) - data_offset[i] + 2; /* entropy data plus RSTn or EOI */
+    }
+
+    /* strips live in their own buffers, so worker 0's output is free to stitch into */
+    encoder_context_t *encoder = &encoders[0];
+
+    if (!reserve_output(&encoder->output, &encoder->output_capacity, (unsigned long)total_size))
+    {
+        return false;
+    }
+
+    unsigned char *out = encoder->output;
+    size_t pos = 0;
+
+    memcpy(out, job->jpeg[0], sos_offset);
+    pos += sos_offset;
+
+    /* stitched frame height replaces the first strip's height */
+    out[sof_offset + 5] = (unsigned char)((source->height >> 8) & 0xFF);
+    out[sof_offset + 6] = (unsigned char)(source->height & 0xFF);
+
+    unsigned int restart_interval = (unsigned int)(mcu_cols * slice_mcu_rows);
+    out[pos++] = 0xFF;
+    out[pos++] = JPEG_MARKER_DRI;
+    out[pos++] = 0x00;
+    out[pos++] = 0x04;
+    out[pos++] = (unsigned char)((restart_interval >> 8) & 0xFF);
+    out[pos++] = (unsigned char)(restart_interval & 0xFF);
+
+    memcpy(out + pos, job->jpeg[0] + sos_offset, data_offset[0] - sos_offset);
+    pos += data_offset[0] - sos_offset;
+
+    for (int i = 0; i < slice_count; ++i)
+    {
+        size_t data_size = (job->jpeg_size[i] - 2) - data_offset[i];
+
+        memcpy(out + pos, job->jpeg[i] + data_offset[i], data_size);
+        pos += data_size;
+
+        out[pos++] = 0xFF;
+        out[pos++] = (i == slice_count - 1) ? JPEG_MARKER_EOI : (unsigned char)(JPEG_MARKER_RST0 + (i % 8));
+    }
+
+    *jpeg = out;
+    *jpeg_size = pos;
+
+    return true;
+}
+
+static void compress_slice_task(void *context, size_t task_index, size_t worker_index)
+{
+    slice_job_t *job = (slice_job_t*)context;
+
+    int first_row = (int)task_index * job->slice_rows;
+    int rows = job->source->height - first_row;
+
+    if (rows > job->slice_rows)
+    {
+        rows = job->slice_rows;
+    }
+
+    job->ok[task_index] = compress_rows(
+        encoders[worker_index].handle,
+        job->source,
+        first_row,
+        rows,
+        job->jpeg[task_index],
+        &job->jpeg_size[task_index]
+    );
+}
+
+static bool find_scan(const unsigned char *jpeg, unsigned long jpeg_size, size_t *sof_offset, size_t *sos_offset, size_t *data_offset)
+{
+    if (!jpeg || jpeg_size < 4 || jpeg[0] != 0xFF || jpeg[1] != 0xD8 ||
+        jpeg[jpeg_size - 2] != 0xFF || jpeg[jpeg_size - 1] != JPEG_MARKER_EOI)
+    {
+        return false;
+    }
+
+    size_t pos = 2;
+    bool have_sof = false;
+
+    while (pos + 4 <= jpeg_size)
+    {
+        if (jpeg[pos] != 0xFF)
+        {
+            return false;
+        }
+
+        unsigned char marker = jpeg[pos + 1];
+        size_t length = ((size_t)jpeg[pos + 2] << 8) | jpeg[pos + 3];
+
+        if (marker == JPEG_MARKER_SOF0 || marker == JPEG_MARKER_SOF1)
+        {
+            *sof_offset = pos;
+            have_sof = true;
+        }
+        else if (marker == JPEG_MARKER_SOS)
+        {
+            *sos_offset = pos;
+            *data_offset = pos + 2 + length;
+            return have_sof && *data_offset <= jpeg_size - 2;
+        }
+
+        pos += 2 + length;
+    }
+
+    return false;
+}
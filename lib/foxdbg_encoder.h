@@ -0,0 +1,69 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_encoder.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server JPEG Encoder
+**
+***************************************************************/
+
+#ifndef FOXDBG_ENCODER_H
+#define FOXDBG_ENCODER_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "foxdbg_channel.h"
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+#define FOXDBG_MAX_JPEG_SLICES (32U)
+
+/* frames smaller than this are always encoded in one piece */
+#define FOXDBG_JPEG_SLICE_MIN_PIXELS (1280U * 720U)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* create one encoder context per worker of the encoder pool */
+bool foxdbg_encoder_init(size_t worker_count);
+
+void foxdbg_encoder_shutdown(void);
+
+/*
+ * compress a raw frame to JPEG, splitting it into up to max_slices strips
+ * encoded in parallel. *jpeg points into the encoder's reusable output
+ * buffer and stays valid until the next call.
+ */
+bool foxdbg_encoder_compress(
+    const foxdbg_image_info_t *info,
+    const uint8_t *pixels, size_t pixels_size,
+    int max_slices,
+    const unsigned char **jpeg, size_t *jpeg_size
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_ENCODER_H */
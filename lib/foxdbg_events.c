@@ -0,0 +1,97 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_events.c
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Event Queue
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_events.h"
+#include "foxdbg_atomic.h"
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+/*
+ * single producer, single consumer ring. head is only written by the
+ * server thread and tail only by the consumer, both count up forever and
+ * wrap together.
+ */
+static foxdbg_event_t events[FOXDBG_EVENT_QUEUE_SIZE];
+static uint32_t head = 0;
+static uint32_t tail = 0;
+
+static int enabled = 0;
+static uint64_t dropped = 0;
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+void foxdbg_events_enable(void)
+{
+    ATOMIC_WRITE_INT(&enabled, 1);
+}
+
+bool foxdbg_events_push(const foxdbg_event_t *event)
+{
+    if (!ATOMIC_READ_INT(&enabled))
+    {
+        return false;
+    }
+
+    uint32_t current = head;
+
+    if (current - ATOMIC_READ_INT(&tail) == FOXDBG_EVENT_QUEUE_SIZE)
+    {
+        ATOMIC_WRITE_U64(&dropped, dropped + 1); /* the consumer is not keeping up */
+        return false;
+    }
+
+    events[current & (FOXDBG_EVENT_QUEUE_SIZE - 1)] = *event;
+    ATOMIC_WRITE_INT(&head, current + 1);
+
+    return true;
+}
+
+bool foxdbg_events_pop(foxdbg_event_t *event)
+{
+    uint32_t current = tail;
+
+    if (current == ATOMIC_READ_INT(&head))
+    {
+        return false;
+    }
+
+    *event = events[current & (FOXDBG_EVENT_QUEUE_SIZE - 1)];
+    ATOMIC_WRITE_INT(&tail, current + 1);
+
+    return true;
+}
+
+uint64_t foxdbg_events_dropped(void)
+{
+    return ATOMIC_READ_U64(&dropped);
+}
@@ -0,0 +1,76 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_events.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Event Queue
+**
+***************************************************************/
+
+#ifndef FOXDBG_EVENTS_H
+#define FOXDBG_EVENTS_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/* events waiting for foxdbg_update, a power of two. newer events are dropped when full */
+#define FOXDBG_EVENT_QUEUE_SIZE (1024U)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+typedef enum
+{
+    FOXDBG_EVENT_RX,            /* the client published to an rx channel */
+    FOXDBG_EVENT_SUBSCRIPTION,  /* the client subscribed to or unsubscribed from a channel */
+    FOXDBG_EVENT_PARAMETER      /* the client set a parameter */
+} foxdbg_event_type_t;
+
+typedef struct
+{
+    foxdbg_event_type_t type;
+    int id;                     /* rx channel, channel or parameter */
+    uint32_t rx_value;          /* value bits, laid out as the rx channel's type */
+    bool subscribed;
+    double parameter_value;
+} foxdbg_event_t;
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* start queueing, called once a callback is registered so nothing piles up without a consumer */
+void foxdbg_events_enable(void);
+
+/* server thread only. false if the queue is full or not enabled */
+bool foxdbg_events_push(const foxdbg_event_t *event);
+
+/* the thread calling foxdbg_update only. false if the queue is empty */
+bool foxdbg_events_pop(foxdbg_event_t *event);
+
+/* events lost to a full queue */
+uint64_t foxdbg_events_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_EVENTS_H */
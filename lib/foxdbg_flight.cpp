@@ -0,0 +1,262 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_flight.cpp
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Flight Recorder
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_flight.h"
+#include "foxdbg_mcap.h"
+#include "foxdbg_time.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+typedef struct
+{
+    int channel_id;
+    const char *topic;
+    const char *schema_name;
+    const char *schema;
+    uint64_t log_time;
+    uint64_t publish_time;
+    std::vector<uint8_t> data;
+} flight_message_t;
+
+/* shared so a dump can hold on to messages the ring has already dropped */
+typedef std::shared_ptr<const flight_message_t> flight_message_ptr_t;
+
+typedef struct
+{
+    std::deque<flight_message_ptr_t> messages;
+    size_t bytes;
+    uint64_t retention;     /* ns */
+} flight_ring_t;
+
+typedef struct
+{
+    std::string path;
+    std::vector<flight_message_ptr_t> messages;
+} flight_dump_t;
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static void dump_thread_main(void);
+static void write_dump(flight_dump_t &dump);
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+/* rings are written by the server thread and copied out by any thread calling dump */
+static std::mutex ring_mutex;
+static std::map<int, flight_ring_t> rings;
+
+/* dumps waiting for the dump thread, started on the first one */
+static std::mutex dump_mutex;
+static std::condition_variable dump_ready;
+static std::deque<flight_dump_t> dumps;
+static bool stopping = false;
+static std::thread dump_thread;
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+void foxdbg_flight_write(
+    int channel_id, const char *topic, const char *schema_name, const char *schema,
+    uint64_t log_time, uint64_t publish_time,
+    const uint8_t *data, size_t size,
+    size_t quota, uint64_t retention_ms)
+{
+    if (size > quota)
+    {
+        return; /* would be dropped straight away */
+    }
+
+    /* copy outside the lock, dumps only wait for the pointer shuffle */
+    flight_message_ptr_t message = std::make_shared<const flight_message_t>(flight_message_t{
+        channel_id, topic, schema_name, schema, log_time, publish_time, std::vector<uint8_t>(data, data + size)
+    });
+
+    uint64_t retention = retention_ms * 1000000ULL;
+
+    std::lock_guard<std::mutex> lock(ring_mutex);
+
+    flight_ring_t &ring = rings[channel_id];
+    ring.retention = retention;
+
+    ring.messages.push_back(std::move(message));
+    ring.bytes += size;
+
+    while (!ring.messages.empty())
+    {
+        const flight_message_t &oldest = *ring.messages.front();
+
+        if (ring.bytes <= quota && publish_time - oldest.publish_time <= retention)
+        {
+            break;
+        }
+
+        ring.bytes -= oldest.data.size();
+        ring.messages.pop_front();
+    }
+}
+
+bool foxdbg_flight_dump(const char *path)
+{
+    flight_dump_t dump;
+    dump.path = path;
+
+    uint64_t now = foxdbg_time_ns();
+
+    {
+        std::lock_guard<std::mutex> lock(ring_mutex);
+
+        for (const auto &ring : rings)
+        {
+            for (const flight_message_ptr_t &message : ring.second.messages)
+            {
+                /* channels that went quiet still hold messages from before the window */
+                if (now - message->publish_time <= ring.second.retention || message->publish_time > now)
+                {
+                    dump.messages.push_back(message);
+                }
+            }
+        }
+    }
+
+    if (dump.messages.empty())
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(dump_mutex);
+
+        if (stopping)
+        {
+            return false;
+        }
+
+        if (!dump_thread.joinable())
+        {
+            dump_thread = std::thread(dump_thread_main);
+        }
+
+        dumps.push_back(std::move(dump));
+    }
+
+    dump_ready.notify_one();
+
+    return true;
+}
+
+void foxdbg_flight_shutdown(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(dump_mutex);
+        stopping = true;
+    }
+
+    dump_ready.notify_one();
+
+    if (dump_thread.joinable())
+    {
+        dump_thread.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        rings.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(dump_mutex);
+    stopping = false;
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+static void dump_thread_main(void)
+{
+    while (true)
+    {
+        flight_dump_t dump;
+
+        {
+            std::unique_lock<std::mutex> lock(dump_mutex);
+            dump_ready.wait(lock, [] { return !dumps.empty() || stopping; });
+
+            if (dumps.empty())
+            {
+                break;
+            }
+
+            dump = std::move(dumps.front());
+            dumps.pop_front();
+        }
+
+        write_dump(dump);
+    }
+}
+
+static void write_dump(flight_dump_t &dump)
+{
+    foxdbg_mcap_writer_t *writer = foxdbg_mcap_writer_open(dump.path.c_str());
+
+    if (!writer)
+    {
+        return;
+    }
+
+    /* interleave the channels in capture order */
+    std::vector<flight_message_ptr_t> &messages = dump.messages;
+
+    std::stable_sort(messages.begin(), messages.end(),
+        [](const flight_message_ptr_t &a, const flight_message_ptr_t &b) { return a->log_time < b->log_time; });
+
+    for (const flight_message_ptr_t &message : messages)
+    {
+        foxdbg_mcap_writer_write(
+            writer,
+            message->channel_id, message->topic, message->schema_name, message->schema,
+            message->log_time, message->publish_time,
+            message->data.data(), message->data.size()
+        );
+    }
+
+    uint64_t message_count = foxdbg_mcap_writer_close(writer);
+
+    printf("FOXDBG: Dumped %llu recent messages to %s\n", (unsigned long long)message_count, dump.path.c_str());
+}
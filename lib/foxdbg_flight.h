@@ -0,0 +1,63 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_flight.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Flight Recorder
+**
+***************************************************************/
+
+#ifndef FOXDBG_FLIGHT_H
+#define FOXDBG_FLIGHT_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * keep one json message in the channel's ring, dropping the oldest ones
+ * beyond quota bytes or retention_ms before publish_time. called from the
+ * server thread, the data is copied, the strings must outlive the process.
+ */
+void foxdbg_flight_write(
+    int channel_id, const char *topic, const char *schema_name, const char *schema,
+    uint64_t log_time, uint64_t publish_time,
+    const uint8_t *data, size_t size,
+    size_t quota, uint64_t retention_ms
+);
+
+/* snapshot every ring and write it to path on the dump thread, false if nothing is kept */
+bool foxdbg_flight_dump(const char *path);
+
+/* finish queued dumps and free the rings */
+void foxdbg_flight_shutdown(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_FLIGHT_H */
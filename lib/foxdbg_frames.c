@@ -0,0 +1,130 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_frames.c
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Frame Name Table
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_frames.h"
+#include "foxdbg_atomic.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+#ifdef _WIN32
+    #define FRAMES_LOCK() AcquireSRWLockExclusive(&frames_lock)
+    #define FRAMES_UNLOCK() ReleaseSRWLockExclusive(&frames_lock)
+#else
+    #define FRAMES_LOCK() pthread_mutex_lock(&frames_lock)
+    #define FRAMES_UNLOCK() pthread_mutex_unlock(&frames_lock)
+#endif
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static int find_frame(const char *name, int first, int count);
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+/* names are written once before frame_count is published, readers need no lock */
+static char frame_names[FOXDBG_MAX_FRAMES][FOXDBG_FRAME_ID_LENGTH];
+static int frame_count = 0;
+
+#ifdef _WIN32
+static SRWLOCK frames_lock = SRWLOCK_INIT;
+#else
+static pthread_mutex_t frames_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+int foxdbg_frames_intern(const char *name)
+{
+    if (!name)
+    {
+        return -1;
+    }
+
+    int count = ATOMIC_READ_INT(&frame_count);
+    int frame = find_frame(name, 0, count);
+
+    if (frame >= 0)
+    {
+        return frame;
+    }
+
+    FRAMES_LOCK();
+
+    /* another thread may have added it since the unlocked search */
+    int locked_count = frame_count;
+    frame = find_frame(name, count, locked_count);
+
+    if (frame < 0 && locked_count < (int)FOXDBG_MAX_FRAMES)
+    {
+        frame = locked_count;
+
+        strncpy(frame_names[frame], name, FOXDBG_FRAME_ID_LENGTH - 1);
+        frame_names[frame][FOXDBG_FRAME_ID_LENGTH - 1] = '\0';
+
+        ATOMIC_WRITE_INT(&frame_count, locked_count + 1);
+    }
+
+    FRAMES_UNLOCK();
+
+    return frame;
+}
+
+const char *foxdbg_frames_name(int frame)
+{
+    if (frame < 0 || frame >= ATOMIC_READ_INT(&frame_count))
+    {
+        return NULL;
+    }
+
+    return frame_names[frame];
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+static int find_frame(const char *name, int first, int count)
+{
+    for (int i = first; i < count; i++)
+    {
+        if (strncmp(frame_names[i], name, FOXDBG_FRAME_ID_LENGTH - 1) == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,57 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_frames.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Frame Name Table
+**
+***************************************************************/
+
+#ifndef FOXDBG_FRAMES_H
+#define FOXDBG_FRAMES_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "foxdbg_channel.h"
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * id of the frame called name, added on first use. names are truncated to
+ * FOXDBG_FRAME_ID_LENGTH - 1 characters. -1 if name is NULL or the table
+ * already holds FOXDBG_MAX_FRAMES names.
+ */
+int foxdbg_frames_intern(const char *name);
+
+/* name of an interned frame, NULL if unknown. never moves once interned */
+const char *foxdbg_frames_name(int frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_FRAMES_H */
@@ -0,0 +1,240 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_hash.c
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Content Hash
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_hash.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define FOXDBG_HASH_SSE2 (1U)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define FOXDBG_HASH_NEON (1U)
+#endif
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/*
+ * xxHash (XXH3 long-input) layout: eight 64-bit accumulators fed 64 bytes
+ * at a time with a 32x32->64 multiply per lane, scrambled every block.
+ * Not bit-compatible with the reference xxHash, only used for equality.
+ */
+#define STRIPE_SIZE         (64U)
+#define STRIPE_LANES        (8U)
+#define STRIPES_PER_BLOCK   (16U)
+
+#define PRIME32_1   (0x9E3779B1U)
+#define PRIME64_1   (0x9E3779B185EBCA87ULL)
+#define PRIME64_2   (0xC2B2AE3D27D4EB4FULL)
+#define PRIME64_3   (0x165667B19E3779F9ULL)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static void accumulate(uint64_t *acc, const uint8_t *data, size_t stripes);
+static void scramble(uint64_t *acc);
+#if !defined(FOXDBG_HASH_SSE2) && !defined(FOXDBG_HASH_NEON)
+static uint64_t read64(const uint8_t *data);
+#endif
+static uint64_t avalanche(uint64_t h);
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+/* per-lane secrets, the first 64 bytes of the XXH3 default secret */
+static const uint64_t secret[STRIPE_LANES] = {
+    0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL,
+    0xDB979083E96DD4DEULL, 0x1F67B3B7A4A44072ULL,
+    0x78E5C0CC4EE679CBULL, 0x2172FFCC7DD05A82ULL,
+    0x8E2443F7744608B8ULL, 0x4C263A81E69035E0ULL
+};
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+uint64_t foxdbg_hash(const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    uint64_t acc[STRIPE_LANES] = {
+        PRIME32_1, PRIME64_1, PRIME64_2, PRIME64_3,
+        PRIME64_2, PRIME32_1, PRIME64_3, PRIME64_1
+    };
+
+    size_t stripes = size / STRIPE_SIZE;
+    const size_t block_size = STRIPE_SIZE * STRIPES_PER_BLOCK;
+
+    while (stripes >= STRIPES_PER_BLOCK)
+    {
+        accumulate(acc, bytes, STRIPES_PER_BLOCK);
+        scramble(acc);
+
+        bytes += block_size;
+        stripes -= STRIPES_PER_BLOCK;
+    }
+
+    accumulate(acc, bytes, stripes);
+    bytes += stripes * STRIPE_SIZE;
+
+    /* zero-padded final stripe, the length below disambiguates the padding */
+    size_t tail = size % STRIPE_SIZE;
+    if (tail > 0)
+    {
+        uint8_t last[STRIPE_SIZE] = { 0 };
+        memcpy(last, bytes, tail);
+        accumulate(acc, last, 1);
+    }
+
+    uint64_t h = (uint64_t)size * PRIME64_1;
+
+    for (size_t i = 0; i < STRIPE_LANES; i += 2)
+    {
+        h += avalanche(acc[i] ^ secret[i]) ^ (avalanche(acc[i + 1] ^ secret[i + 1]) * PRIME64_2);
+    }
+
+    return avalanche(h);
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+static void accumulate(uint64_t *acc, const uint8_t *data, size_t stripes)
+{
+#if defined(FOXDBG_HASH_SSE2)
+
+    __m128i a[STRIPE_LANES / 2];
+    __m128i k[STRIPE_LANES / 2];
+
+    for (size_t j = 0; j < STRIPE_LANES / 2; j++)
+    {
+        a[j] = _mm_loadu_si128((const __m128i *)(acc + j * 2));
+        k[j] = _mm_loadu_si128((const __m128i *)(secret + j * 2));
+    }
+
+    for (size_t s = 0; s < stripes; s++)
+    {
+        const uint8_t *stripe = data + s * STRIPE_SIZE;
+
+        for (size_t j = 0; j < STRIPE_LANES / 2; j++)
+        {
+            __m128i d = _mm_loadu_si128((const __m128i *)(stripe + j * 16));
+            __m128i dk = _mm_xor_si128(d, k[j]);
+
+            /* low 32 bits times high 32 bits of every 64-bit lane */
+            __m128i product = _mm_mul_epu32(dk, _mm_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m128i swapped = _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+
+            a[j] = _mm_add_epi64(a[j], _mm_add_epi64(product, swapped));
+        }
+    }
+
+    for (size_t j = 0; j < STRIPE_LANES / 2; j++)
+    {
+        _mm_storeu_si128((__m128i *)(acc + j * 2), a[j]);
+    }
+
+#elif defined(FOXDBG_HASH_NEON)
+
+    uint64x2_t a[STRIPE_LANES / 2];
+    uint64x2_t k[STRIPE_LANES / 2];
+
+    for (size_t j = 0; j < STRIPE_LANES / 2; j++)
+    {
+        a[j] = vld1q_u64(acc + j * 2);
+        k[j] = vld1q_u64(secret + j * 2);
+    }
+
+    for (size_t s = 0; s < stripes; s++)
+    {
+        const uint8_t *stripe = data + s * STRIPE_SIZE;
+
+        for (size_t j = 0; j < STRIPE_LANES / 2; j++)
+        {
+            uint64x2_t d = vreinterpretq_u64_u8(vld1q_u8(stripe + j * 16));
+            uint64x2_t dk = veorq_u64(d, k[j]);
+
+            uint64x2_t product = vmull_u32(vmovn_u64(dk), vshrn_n_u64(dk, 32));
+            uint64x2_t swapped = vextq_u64(d, d, 1);
+
+            a[j] = vaddq_u64(a[j], vaddq_u64(product, swapped));
+        }
+    }
+
+    for (size_t j = 0; j < STRIPE_LANES / 2; j++)
+    {
+        vst1q_u64(acc + j * 2, a[j]);
+    }
+
+#else
+
+    for (size_t s = 0; s < stripes; s++)
+    {
+        const uint8_t *stripe = data + s * STRIPE_SIZE;
+
+        for (size_t i = 0; i < STRIPE_LANES; i++)
+        {
+            uint64_t d = read64(stripe + i * 8);
+            uint64_t dk = d ^ secret[i];
+
+            acc[i ^ 1] += d;
+            acc[i] += (dk & 0xFFFFFFFFULL) * (dk >> 32);
+        }
+    }
+
+#endif
+}
+
+static void scramble(uint64_t *acc)
+{
+    for (size_t i = 0; i < STRIPE_LANES; i++)
+    {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= secret[STRIPE_LANES - 1 - i];
+        acc[i] = a * PRIME32_1;
+    }
+}
+
+#if !defined(FOXDBG_HASH_SSE2) && !defined(FOXDBG_HASH_NEON)
+/* only the scalar accumulate reads unaligned lanes */
+static uint64_t read64(const uint8_t *data)
+{
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+#endif
+
+static uint64_t avalanche(uint64_t h)
+{
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+    return h;
+}
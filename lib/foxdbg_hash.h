@@ -0,0 +1,48 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_hash.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Content Hash
+**
+***************************************************************/
+
+#ifndef FOXDBG_HASH_H
+#define FOXDBG_HASH_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 64-bit non-cryptographic hash of a payload, used to detect unchanged frames */
+uint64_t foxdbg_hash(const void *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_HASH_H */
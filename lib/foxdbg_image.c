@@ -0,0 +1,301 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_image.c
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Image Helpers
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_image.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define FOXDBG_IMAGE_SSE2 (1U)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define FOXDBG_IMAGE_NEON (1U)
+#endif
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/* JFIF (full range BT.601) coefficients in 8.8 fixed point */
+#define Y_R     (77U)
+#define Y_G     (150U)
+#define Y_B     (29U)
+#define CB_R    (43U)   /* negative */
+#define CB_G    (85U)   /* negative */
+#define CB_B    (128U)
+#define CR_R    (128U)
+#define CR_G    (107U)  /* negative */
+#define CR_B    (21U)   /* negative */
+
+/* keeps every chroma intermediate inside [0, 65535] so 16-bit lanes never wrap */
+#define CHROMA_BIAS (32768U)
+#define LUMA_ROUND  (128U)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static void bayer_quads_scalar(const uint8_t *row0, const uint8_t *row1, uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v, int quads);
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+foxdbg_pixel_format_t foxdbg_image_pixel_format(const foxdbg_image_info_t *info)
+{
+    /* callers filling the info field by field may leave format uninitialised */
+    int format = (int)info->format;
+
+    if (format > (int)FOXDBG_PIXEL_FORMAT_AUTO && format <= (int)FOXDBG_PIXEL_FORMAT_PNG)
+    {
+        return info->format;
+    }
+
+    switch (info->channels)
+    {
+        case 1:  return FOXDBG_PIXEL_FORMAT_GRAY;
+        case 4:  return FOXDBG_PIXEL_FORMAT_RGBA;
+        default: return FOXDBG_PIXEL_FORMAT_RGB;
+    }
+}
+
+bool foxdbg_image_is_compressed(foxdbg_pixel_format_t format)
+{
+    return format == FOXDBG_PIXEL_FORMAT_JPEG || format == FOXDBG_PIXEL_FORMAT_PNG;
+}
+
+size_t foxdbg_image_frame_size(foxdbg_pixel_format_t format, int width, int height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return 0;
+    }
+
+    size_t pixels = (size_t)width * (size_t)height;
+    size_t chroma = (size_t)((width + 1) / 2) * (size_t)((height + 1) / 2);
+
+    switch (format)
+    {
+        case FOXDBG_PIXEL_FORMAT_GRAY:
+        case FOXDBG_PIXEL_FORMAT_BAYER_RGGB:
+        {
+            return pixels;
+        }
+
+        case FOXDBG_PIXEL_FORMAT_RGB:
+        case FOXDBG_PIXEL_FORMAT_BGR:
+        {
+            return pixels * 3;
+        }
+
+        case FOXDBG_PIXEL_FORMAT_RGBA:
+        case FOXDBG_PIXEL_FORMAT_BGRA:
+        case FOXDBG_PIXEL_FORMAT_BGRX:
+        {
+            return pixels * 4;
+        }
+
+        case FOXDBG_PIXEL_FORMAT_I420:
+        case FOXDBG_PIXEL_FORMAT_NV12:
+        {
+            return pixels + 2 * chroma;
+        }
+
+        default:
+        {
+            return 0;
+        }
+    }
+}
+
+void foxdbg_image_deinterleave_uv(const uint8_t *uv, uint8_t *u, uint8_t *v, size_t count)
+{
+    size_t i = 0;
+
+#if defined(FOXDBG_IMAGE_SSE2)
+    const __m128i mask = _mm_set1_epi16(0x00FF);
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(uv + 2 * i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(uv + 2 * i + 16));
+
+        __m128i u_out = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+        __m128i v_out = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+
+        _mm_storeu_si128((__m128i *)(u + i), u_out);
+        _mm_storeu_si128((__m128i *)(v + i), v_out);
+    }
+#elif defined(FOXDBG_IMAGE_NEON)
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x2_t pair = vld2q_u8(uv + 2 * i);
+        vst1q_u8(u + i, pair.val[0]);
+        vst1q_u8(v + i, pair.val[1]);
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        u[i] = uv[2 * i];
+        v[i] = uv[2 * i + 1];
+    }
+}
+
+bool foxdbg_image_bayer_rggb_to_i420(const uint8_t *src, int width, int height, uint8_t *y, uint8_t *u, uint8_t *v)
+{
+    if (width <= 0 || height <= 0 || (width % 2) != 0 || (height % 2) != 0)
+    {
+        return false;
+    }
+
+    /*
+     * Each 2x2 RGGB quad maps onto exactly one 4:2:0 chroma sample, so chroma
+     * comes from the quad colour and luma keeps the per-site green detail.
+     */
+    int quads_per_row = width / 2;
+
+    for (int row = 0; row < height; row += 2)
+    {
+        const uint8_t *row0 = src + (size_t)row * width;
+        const uint8_t *row1 = row0 + width;
+        uint8_t *y0 = y + (size_t)row * width;
+        uint8_t *y1 = y0 + width;
+        uint8_t *u_row = u + (size_t)(row / 2) * quads_per_row;
+        uint8_t *v_row = v + (size_t)(row / 2) * quads_per_row;
+
+        int q = 0;
+
+#if defined(FOXDBG_IMAGE_SSE2)
+        const __m128i mask = _mm_set1_epi16(0x00FF);
+
+        for (; q + 8 <= quads_per_row; q += 8)
+        {
+            __m128i even = _mm_loadu_si128((const __m128i *)(row0 + 2 * q));
+            __m128i odd = _mm_loadu_si128((const __m128i *)(row1 + 2 * q));
+
+            __m128i r = _mm_and_si128(even, mask);
+            __m128i g1 = _mm_srli_epi16(even, 8);
+            __m128i g2 = _mm_and_si128(odd, mask);
+            __m128i b = _mm_srli_epi16(odd, 8);
+            __m128i g = _mm_avg_epu16(g1, g2);
+
+            __m128i rb = _mm_add_epi16(
+                _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(Y_R)), _mm_mullo_epi16(b, _mm_set1_epi16(Y_B))),
+                _mm_set1_epi16(LUMA_ROUND)
+            );
+
+            __m128i y_rb = _mm_srli_epi16(_mm_add_epi16(rb, _mm_mullo_epi16(g, _mm_set1_epi16(Y_G))), 8);
+            __m128i y_g1 = _mm_srli_epi16(_mm_add_epi16(rb, _mm_mullo_epi16(g1, _mm_set1_epi16(Y_G))), 8);
+            __m128i y_g2 = _mm_srli_epi16(_mm_add_epi16(rb, _mm_mullo_epi16(g2, _mm_set1_epi16(Y_G))), 8);
+
+            _mm_storeu_si128((__m128i *)(y0 + 2 * q), _mm_or_si128(y_rb, _mm_slli_epi16(y_g1, 8)));
+            _mm_storeu_si128((__m128i *)(y1 + 2 * q), _mm_or_si128(y_g2, _mm_slli_epi16(y_rb, 8)));
+
+            __m128i cb = _mm_sub_epi16(
+                _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(CB_B)), _mm_set1_epi16((short)CHROMA_BIAS)),
+                _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(CB_R)), _mm_mullo_epi16(g, _mm_set1_epi16(CB_G)))
+            );
+
+            __m128i cr = _mm_sub_epi16(
+                _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(CR_R)), _mm_set1_epi16((short)CHROMA_BIAS)),
+                _mm_add_epi16(_mm_mullo_epi16(g, _mm_set1_epi16(CR_G)), _mm_mullo_epi16(b, _mm_set1_epi16(CR_B)))
+            );
+
+            cb = _mm_srli_epi16(cb, 8);
+            cr = _mm_srli_epi16(cr, 8);
+
+            _mm_storel_epi64((__m128i *)(u_row + q), _mm_packus_epi16(cb, cb));
+            _mm_storel_epi64((__m128i *)(v_row + q), _mm_packus_epi16(cr, cr));
+        }
+#elif defined(FOXDBG_IMAGE_NEON)
+        for (; q + 8 <= quads_per_row; q += 8)
+        {
+            uint8x8x2_t even = vld2_u8(row0 + 2 * q);
+            uint8x8x2_t odd = vld2_u8(row1 + 2 * q);
+
+            uint16x8_t r = vmovl_u8(even.val[0]);
+            uint16x8_t g1 = vmovl_u8(even.val[1]);
+            uint16x8_t g2 = vmovl_u8(odd.val[0]);
+            uint16x8_t b = vmovl_u8(odd.val[1]);
+            uint16x8_t g = vrhaddq_u16(g1, g2);
+
+            uint16x8_t rb = vmlaq_n_u16(vmlaq_n_u16(vdupq_n_u16(LUMA_ROUND), r, Y_R), b, Y_B);
+
+            uint8x8_t y_rb = vshrn_n_u16(vmlaq_n_u16(rb, g, Y_G), 8);
+            uint8x8_t y_g1 = vshrn_n_u16(vmlaq_n_u16(rb, g1, Y_G), 8);
+            uint8x8_t y_g2 = vshrn_n_u16(vmlaq_n_u16(rb, g2, Y_G), 8);
+
+            uint8x8x2_t out0 = { { y_rb, y_g1 } };
+            uint8x8x2_t out1 = { { y_g2, y_rb } };
+            vst2_u8(y0 + 2 * q, out0);
+            vst2_u8(y1 + 2 * q, out1);
+
+            uint16x8_t cb = vmlaq_n_u16(vdupq_n_u16(CHROMA_BIAS), b, CB_B);
+            cb = vmlsq_n_u16(vmlsq_n_u16(cb, r, CB_R), g, CB_G);
+
+            uint16x8_t cr = vmlaq_n_u16(vdupq_n_u16(CHROMA_BIAS), r, CR_R);
+            cr = vmlsq_n_u16(vmlsq_n_u16(cr, g, CR_G), b, CR_B);
+
+            vst1_u8(u_row + q, vshrn_n_u16(cb, 8));
+            vst1_u8(v_row + q, vshrn_n_u16(cr, 8));
+        }
+#endif
+
+        bayer_quads_scalar(row0 + 2 * q, row1 + 2 * q, y0 + 2 * q, y1 + 2 * q, u_row + q, v_row + q, quads_per_row - q);
+    }
+
+    return true;
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+static void bayer_quads_scalar(const uint8_t *row0, const uint8_t *row1, uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v, int quads)
+{
+    for (int q = 0; q < quads; ++q)
+    {
+        uint32_t r = row0[2 * q];
+        uint32_t g1 = row0[2 * q + 1];
+        uint32_t g2 = row1[2 * q];
+        uint32_t b = row1[2 * q + 1];
+        uint32_t g = (g1 + g2 + 1) >> 1;
+
+        uint32_t rb = Y_R * r + Y_B * b + LUMA_ROUND;
+
+        uint8_t y_rb = (uint8_t)((rb + Y_G * g) >> 8);
+
+        y0[2 * q] = y_rb;
+        y0[2 * q + 1] = (uint8_t)((rb + Y_G * g1) >> 8);
+        y1[2 * q] = (uint8_t)((rb + Y_G * g2) >> 8);
+        y1[2 * q + 1] = y_rb;
+
+        u[q] = (uint8_t)((CB_B * b + CHROMA_BIAS - CB_R * r - CB_G * g) >> 8);
+        v[q] = (uint8_t)((CR_R * r + CHROMA_BIAS - CR_G * g - CR_B * b) >> 8);
+    }
+}
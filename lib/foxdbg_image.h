@@ -0,0 +1,62 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_image.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Image Helpers
+**
+***************************************************************/
+
+#ifndef FOXDBG_IMAGE_H
+#define FOXDBG_IMAGE_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "foxdbg_channel.h"
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* resolve FOXDBG_PIXEL_FORMAT_AUTO, or any value outside the enum, from the channel count */
+foxdbg_pixel_format_t foxdbg_image_pixel_format(const foxdbg_image_info_t *info);
+
+/* true if the frame is already an encoded bitstream */
+bool foxdbg_image_is_compressed(foxdbg_pixel_format_t format);
+
+/* number of bytes a raw frame of this format occupies, 0 if unsupported */
+size_t foxdbg_image_frame_size(foxdbg_pixel_format_t format, int width, int height);
+
+/* split an interleaved NV12 chroma plane into separate U and V planes */
+void foxdbg_image_deinterleave_uv(const uint8_t *uv, uint8_t *u, uint8_t *v, size_t count);
+
+/* demosaic a Bayer RGGB frame straight into I420 planes (width and height must be even) */
+bool foxdbg_image_bayer_rggb_to_i420(const uint8_t *src, int width, int height, uint8_t *y, uint8_t *u, uint8_t *v);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_IMAGE_H */
@@ -0,0 +1,477 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_json.c
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server JSON Reader
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_json.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/* longest number literal converted, longer ones are rejected */
+#define NUMBER_LENGTH (64U)
+
+/* escaped strings compared by foxdbg_json_equals are decoded into this much stack */
+#define EQUALS_LENGTH (256U)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static const char *skip_whitespace(const char *p, const char *end);
+static const char *read_string(const char *p, const char *end, foxdbg_json_event_t *event);
+static const char *read_scalar(const char *p, const char *end, foxdbg_json_event_t *event);
+static const char *read_key(const char *p, const char *end, size_t depth, foxdbg_json_handler_t handler, void *context, bool *stopped);
+static bool integer_literal(const char *text, size_t length, double *number);
+static int hex_value(char c);
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+foxdbg_json_result_t foxdbg_json_parse(const char *text, size_t length, foxdbg_json_handler_t handler, void *context)
+{
+    const char *p = text;
+    const char *end = text + length;
+
+    /* '{' or '[' for every open container */
+    char stack[FOXDBG_JSON_MAX_DEPTH];
+    size_t depth = 0;
+
+    bool expect_value = true;
+    bool stopped = false;
+
+    foxdbg_json_event_t event;
+    memset(&event, 0, sizeof(event));
+
+    while (true)
+    {
+        p = skip_whitespace(p, end);
+
+        if (expect_value)
+        {
+            if (p == end)
+            {
+                return FOXDBG_JSON_INVALID;
+            }
+
+            if (*p == '{' || *p == '[')
+            {
+                bool object = *p == '{';
+
+                if (depth == FOXDBG_JSON_MAX_DEPTH)
+                {
+                    return FOXDBG_JSON_INVALID;
+                }
+
+                event.type = object ? FOXDBG_JSON_OBJECT_BEGIN : FOXDBG_JSON_ARRAY_BEGIN;
+                event.depth = depth;
+
+                if (!handler(context, &event))
+                {
+                    return FOXDBG_JSON_STOPPED;
+                }
+
+                stack[depth++] = *p;
+                p = skip_whitespace(p + 1, end);
+
+                if (p < end && *p == (object ? '}' : ']'))
+                {
+                    /* empty, closed below like any other container */
+                    expect_value = false;
+                    continue;
+                }
+
+                if (object)
+                {
+                    p = read_key(p, end, depth, handler, context, &stopped);
+
+                    if (!p)
+                    {
+                        return stopped ? FOXDBG_JSON_STOPPED : FOXDBG_JSON_INVALID;
+                    }
+                }
+
+                continue;
+            }
+
+            p = (*p == '"') ? read_string(p, end, &event) : read_scalar(p, end, &event);
+
+            if (!p)
+            {
+                return FOXDBG_JSON_INVALID;
+            }
+
+            event.depth = depth;
+
+            if (!handler(context, &event))
+            {
+                return FOXDBG_JSON_STOPPED;
+            }
+
+            expect_value = false;
+            continue;
+        }
+
+        if (depth == 0)
+        {
+            return (p == end) ? FOXDBG_JSON_OK : FOXDBG_JSON_INVALID;
+        }
+
+        if (p == end)
+        {
+            return FOXDBG_JSON_INVALID;
+        }
+
+        bool object = stack[depth - 1] == '{';
+
+        if (*p == ',')
+        {
+            p = skip_whitespace(p + 1, end);
+
+            if (object)
+            {
+                p = read_key(p, end, depth, handler, context, &stopped);
+
+                if (!p)
+                {
+                    return stopped ? FOXDBG_JSON_STOPPED : FOXDBG_JSON_INVALID;
+                }
+            }
+
+            expect_value = true;
+        }
+        else if (*p == (object ? '}' : ']'))
+        {
+            depth--;
+            p++;
+
+            event.type = object ? FOXDBG_JSON_OBJECT_END : FOXDBG_JSON_ARRAY_END;
+            event.depth = depth;
+            event.text = NULL;
+            event.length = 0;
+
+            if (!handler(context, &event))
+            {
+                return FOXDBG_JSON_STOPPED;
+            }
+        }
+        else
+        {
+            return FOXDBG_JSON_INVALID;
+        }
+    }
+}
+
+size_t foxdbg_json_unescape(const char *text, size_t length, char *out, size_t out_size)
+{
+    const char *end = text + length;
+    size_t written = 0;
+
+    while (text < end)
+    {
+        char utf8[4];
+        size_t count = 1;
+
+        if (*text != '\\')
+        {
+            utf8[0] = *text++;
+        }
+        else if (end - text >= 2 && text[1] != 'u')
+        {
+            switch (text[1])
+            {
+                case 'b': utf8[0] = '\b'; break;
+                case 'f': utf8[0] = '\f'; break;
+                case 'n': utf8[0] = '\n'; break;
+                case 'r': utf8[0] = '\r'; break;
+                case 't': utf8[0] = '\t'; break;
+                default:  utf8[0] = text[1]; break; /* \" \\ \/ */
+            }
+
+            text += 2;
+        }
+        else if (end - text >= 6)
+        {
+            /* \uXXXX, surrogate pairs are kept as two 3 byte sequences */
+            unsigned code = 0;
+
+            for (int i = 2; i < 6; i++)
+            {
+                int digit = hex_value(text[i]);
+
+                if (digit < 0)
+                {
+                    return (size_t)-1;
+                }
+
+                code = (code << 4) | (unsigned)digit;
+            }
+
+            if (code < 0x80)
+            {
+                utf8[0] = (char)code;
+            }
+            else if (code < 0x800)
+            {
+                utf8[0] = (char)(0xC0 | (code >> 6));
+                utf8[1] = (char)(0x80 | (code & 0x3F));
+                count = 2;
+            }
+            else
+            {
+                utf8[0] = (char)(0xE0 | (code >> 12));
+                utf8[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+                utf8[2] = (char)(0x80 | (code & 0x3F));
+                count = 3;
+            }
+
+            text += 6;
+        }
+        else
+        {
+            return (size_t)-1;
+        }
+
+        if (written + count >= out_size)
+        {
+            return (size_t)-1;
+        }
+
+        memcpy(out + written, utf8, count);
+        written += count;
+    }
+
+    if (written >= out_size)
+    {
+        return (size_t)-1;
+    }
+
+    out[written] = '\0';
+
+    return written;
+}
+
+bool foxdbg_json_equals(const foxdbg_json_event_t *event, const char *literal)
+{
+    if (event->type != FOXDBG_JSON_KEY && event->type != FOXDBG_JSON_STRING)
+    {
+        return false;
+    }
+
+    size_t literal_length = strlen(literal);
+
+    if (!event->escaped)
+    {
+        return event->length == literal_length && memcmp(event->text, literal, literal_length) == 0;
+    }
+
+    char decoded[EQUALS_LENGTH];
+    size_t decoded_length = foxdbg_json_unescape(event->text, event->length, decoded, sizeof(decoded));
+
+    return decoded_length == literal_length && memcmp(decoded, literal, literal_length) == 0;
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+static const char *skip_whitespace(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+    {
+        p++;
+    }
+
+    return p;
+}
+
+/* p is on the opening quote, returns just past the closing one */
+static const char *read_string(const char *p, const char *end, foxdbg_json_event_t *event)
+{
+    event->type = FOXDBG_JSON_STRING;
+    event->text = ++p;
+    event->escaped = false;
+
+    for (; p < end; p++)
+    {
+        if (*p == '\\')
+        {
+            event->escaped = true;
+            p++;
+        }
+        else if (*p == '"')
+        {
+            event->length = (size_t)(p - event->text);
+            return p + 1;
+        }
+        else if ((unsigned char)*p < 0x20)
+        {
+            return NULL; /* control characters must be escaped */
+        }
+    }
+
+    return NULL;
+}
+
+/* number, true, false or null */
+static const char *read_scalar(const char *p, const char *end, foxdbg_json_event_t *event)
+{
+    const char *start = p;
+
+    while (p < end && strchr("+-0123456789.eEtruefalsn", *p) && *p != '\0')
+    {
+        p++;
+    }
+
+    size_t length = (size_t)(p - start);
+
+    event->text = start;
+    event->length = length;
+    event->escaped = false;
+    event->number = 0.0;
+
+    if (length == 4 && memcmp(start, "true", 4) == 0)
+    {
+        event->type = FOXDBG_JSON_TRUE;
+    }
+    else if (length == 5 && memcmp(start, "false", 5) == 0)
+    {
+        event->type = FOXDBG_JSON_FALSE;
+    }
+    else if (length == 4 && memcmp(start, "null", 4) == 0)
+    {
+        event->type = FOXDBG_JSON_NULL;
+    }
+    else if (length < 16 && integer_literal(start, length, &event->number))
+    {
+        event->type = FOXDBG_JSON_NUMBER; /* ids and counts, most numbers a client sends */
+    }
+    else
+    {
+        /* strtod needs a terminated string */
+        char number[NUMBER_LENGTH];
+
+        if (length == 0 || length >= sizeof(number) || !(*start == '-' || (*start >= '0' && *start <= '9')))
+        {
+            return NULL;
+        }
+
+        memcpy(number, start, length);
+        number[length] = '\0';
+
+        char *number_end;
+        event->type = FOXDBG_JSON_NUMBER;
+        event->number = strtod(number, &number_end);
+
+        if (number_end != number + length || !isfinite(event->number))
+        {
+            return NULL;
+        }
+    }
+
+    return p;
+}
+
+/* a key and its colon, NULL if malformed or the handler stopped */
+static const char *read_key(const char *p, const char *end, size_t depth, foxdbg_json_handler_t handler, void *context, bool *stopped)
+{
+    foxdbg_json_event_t event;
+
+    if (p == end || *p != '"' || !(p = read_string(p, end, &event)))
+    {
+        return NULL;
+    }
+
+    event.type = FOXDBG_JSON_KEY;
+    event.depth = depth;
+    event.number = 0.0;
+
+    if (!handler(context, &event))
+    {
+        *stopped = true;
+        return NULL;
+    }
+
+    p = skip_whitespace(p, end);
+
+    if (p == end || *p != ':')
+    {
+        return NULL;
+    }
+
+    return p + 1;
+}
+
+/* exact for the up to 15 digits it is given, no leading zeros as in JSON */
+static bool integer_literal(const char *text, size_t length, double *number)
+{
+    bool negative = length > 0 && text[0] == '-';
+    size_t first = negative ? 1 : 0;
+
+    if (length == first || (text[first] == '0' && length > first + 1))
+    {
+        return false;
+    }
+
+    int64_t value = 0;
+
+    for (size_t i = first; i < length; i++)
+    {
+        if (text[i] < '0' || text[i] > '9')
+        {
+            return false;
+        }
+
+        value = value * 10 + (text[i] - '0');
+    }
+
+    *number = negative ? -(double)value : (double)value;
+
+    return true;
+}
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
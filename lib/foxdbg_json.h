@@ -0,0 +1,98 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_json.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server JSON Reader
+**
+***************************************************************/
+
+#ifndef FOXDBG_JSON_H
+#define FOXDBG_JSON_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/* deepest nesting accepted, the parser's only state besides the input */
+#define FOXDBG_JSON_MAX_DEPTH (32U)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+typedef enum
+{
+    FOXDBG_JSON_OBJECT_BEGIN,
+    FOXDBG_JSON_OBJECT_END,
+    FOXDBG_JSON_ARRAY_BEGIN,
+    FOXDBG_JSON_ARRAY_END,
+    FOXDBG_JSON_KEY,
+    FOXDBG_JSON_STRING,
+    FOXDBG_JSON_NUMBER,
+    FOXDBG_JSON_TRUE,
+    FOXDBG_JSON_FALSE,
+    FOXDBG_JSON_NULL
+} foxdbg_json_event_type_t;
+
+typedef struct
+{
+    foxdbg_json_event_type_t type;
+    size_t depth;           /* containers around the event, a container's begin and end are outside it */
+    const char *text;       /* keys and strings: between the quotes, numbers: the literal. points into the input */
+    size_t length;
+    bool escaped;           /* text holds escape sequences, see foxdbg_json_unescape */
+    double number;
+} foxdbg_json_event_t;
+
+/* return false to stop parsing */
+typedef bool (*foxdbg_json_handler_t)(void *context, const foxdbg_json_event_t *event);
+
+typedef enum
+{
+    FOXDBG_JSON_OK,
+    FOXDBG_JSON_STOPPED,    /* the handler returned false */
+    FOXDBG_JSON_INVALID     /* malformed or nested deeper than FOXDBG_JSON_MAX_DEPTH */
+} foxdbg_json_result_t;
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * walk one JSON value in text, calling handler for every event in order.
+ * nothing is allocated or copied, events up to a syntax error have
+ * already been delivered when FOXDBG_JSON_INVALID is returned.
+ */
+foxdbg_json_result_t foxdbg_json_parse(const char *text, size_t length, foxdbg_json_handler_t handler, void *context);
+
+/*
+ * decode the escapes of a key or string into out and terminate it.
+ * returns the decoded length, or size_t(-1) if it does not fit in out_size
+ */
+size_t foxdbg_json_unescape(const char *text, size_t length, char *out, size_t out_size);
+
+/* key or string event equals the terminated string literal */
+bool foxdbg_json_equals(const foxdbg_json_event_t *event, const char *literal);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_JSON_H */
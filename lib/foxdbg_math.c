@@ -0,0 +1,265 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_math.c
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Math Helpers
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_math.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define FOXDBG_MATH_AVX2 (1U)
+    #define BATCH (8U)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define FOXDBG_MATH_SSE2 (1U)
+    #define BATCH (4U)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define FOXDBG_MATH_NEON (1U)
+    #define BATCH (4U)
+#else
+    #define FOXDBG_MATH_SCALAR (1U)
+    #define BATCH (4U)
+#endif
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+#define TWO_OVER_PI (0.636619772367581343076f)
+
+/* pi/2 split in three so the range reduction stays exact (Cody-Waite) */
+#define PIO2_1 (1.5703125f)
+#define PIO2_2 (4.837512969970703125e-4f)
+#define PIO2_3 (7.549789954891882e-8f)
+
+/* minimax polynomials on [-pi/4, pi/4], from cephes sinf/cosf */
+#define SIN_C1 (-1.6666654611e-1f)
+#define SIN_C2 (8.3321608736e-3f)
+#define SIN_C3 (-1.9515295891e-4f)
+#define COS_C1 (4.166664568298827e-2f)
+#define COS_C2 (-1.388731625493765e-3f)
+#define COS_C3 (2.443315711809948e-5f)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static void sincos_batch(const float *angle, float *s, float *c);
+
+#if defined(FOXDBG_MATH_SCALAR)
+static void sincos_scalar(float angle, float *s, float *c);
+#endif
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+void foxdbg_math_euler_to_quaternion(
+    const foxdbg_vector3_t *euler, size_t euler_stride,
+    float yaw_offset,
+    foxdbg_vector4_t *quaternions, size_t count)
+{
+    const uint8_t *src = (const uint8_t *)euler;
+
+    for (size_t base = 0; base < count; base += BATCH)
+    {
+        size_t lanes = (count - base) < BATCH ? (count - base) : BATCH;
+
+        /* gather half angles into SoA lanes, pitch | roll | yaw */
+        float half[3 * BATCH] = { 0 };
+        float s[3 * BATCH];
+        float c[3 * BATCH];
+
+        for (size_t k = 0; k < lanes; k++)
+        {
+            const foxdbg_vector3_t *e = (const foxdbg_vector3_t *)(src + (base + k) * euler_stride);
+
+            half[k] = e->x * 0.5f;
+            half[BATCH + k] = e->y * 0.5f;
+            half[2 * BATCH + k] = (e->z + yaw_offset) * 0.5f;
+        }
+
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            sincos_batch(half + axis * BATCH, s + axis * BATCH, c + axis * BATCH);
+        }
+
+        const float *sp = s, *cp = c;
+        const float *sr = s + BATCH, *cr = c + BATCH;
+        const float *sy = s + 2 * BATCH, *cy = c + 2 * BATCH;
+
+        for (size_t k = 0; k < lanes; k++)
+        {
+            foxdbg_vector4_t *q = &quaternions[base + k];
+
+            q->x = sr[k] * cp[k] * cy[k] - cr[k] * sp[k] * sy[k];
+            q->y = cr[k] * sp[k] * cy[k] + sr[k] * cp[k] * sy[k];
+            q->z = cr[k] * cp[k] * sy[k] - sr[k] * sp[k] * cy[k];
+            q->w = cr[k] * cp[k] * cy[k] + sr[k] * sp[k] * sy[k];
+        }
+    }
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+/* sine and cosine of BATCH angles */
+static void sincos_batch(const float *angle, float *s, float *c)
+{
+#if defined(FOXDBG_MATH_AVX2)
+
+    __m256 x = _mm256_loadu_ps(angle);
+
+    /* quadrant and remainder in [-pi/4, pi/4] */
+    __m256 j = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(TWO_OVER_PI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(j, _mm256_set1_ps(PIO2_1)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(PIO2_2)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(PIO2_3)));
+    __m256i q = _mm256_cvtps_epi32(j);
+
+    __m256 r2 = _mm256_mul_ps(r, r);
+
+    __m256 ps = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(SIN_C3), r2), _mm256_set1_ps(SIN_C2));
+    ps = _mm256_add_ps(_mm256_mul_ps(ps, r2), _mm256_set1_ps(SIN_C1));
+    ps = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(ps, r2), r), r);
+
+    __m256 pc = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(COS_C3), r2), _mm256_set1_ps(COS_C2));
+    pc = _mm256_add_ps(_mm256_mul_ps(pc, r2), _mm256_set1_ps(COS_C1));
+    pc = _mm256_mul_ps(_mm256_mul_ps(pc, r2), r2);
+    pc = _mm256_add_ps(_mm256_sub_ps(pc, _mm256_mul_ps(_mm256_set1_ps(0.5f), r2)), _mm256_set1_ps(1.0f));
+
+    /* odd quadrants swap sine and cosine, the sign follows the quadrant */
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+    __m256 sin_v = _mm256_blendv_ps(ps, pc, swap);
+    __m256 cos_v = _mm256_blendv_ps(pc, ps, swap);
+
+    __m256 sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+    __m256 cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+
+    _mm256_storeu_ps(s, _mm256_xor_ps(sin_v, sin_sign));
+    _mm256_storeu_ps(c, _mm256_xor_ps(cos_v, cos_sign));
+
+#elif defined(FOXDBG_MATH_SSE2)
+
+    __m128 x = _mm_loadu_ps(angle);
+
+    /* SSE2 has no round, cvtps_epi32 rounds to nearest in the default mode */
+    __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI)));
+    __m128 j = _mm_cvtepi32_ps(q);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(j, _mm_set1_ps(PIO2_1)));
+    r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(PIO2_2)));
+    r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(PIO2_3)));
+
+    __m128 r2 = _mm_mul_ps(r, r);
+
+    __m128 ps = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SIN_C3), r2), _mm_set1_ps(SIN_C2));
+    ps = _mm_add_ps(_mm_mul_ps(ps, r2), _mm_set1_ps(SIN_C1));
+    ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, r2), r), r);
+
+    __m128 pc = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(COS_C3), r2), _mm_set1_ps(COS_C2));
+    pc = _mm_add_ps(_mm_mul_ps(pc, r2), _mm_set1_ps(COS_C1));
+    pc = _mm_mul_ps(_mm_mul_ps(pc, r2), r2);
+    pc = _mm_add_ps(_mm_sub_ps(pc, _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_set1_ps(1.0f));
+
+    /* odd quadrants swap sine and cosine, the sign follows the quadrant */
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    __m128 sin_v = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+    __m128 cos_v = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+
+    __m128 sin_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+    __m128 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+
+    _mm_storeu_ps(s, _mm_xor_ps(sin_v, sin_sign));
+    _mm_storeu_ps(c, _mm_xor_ps(cos_v, cos_sign));
+
+#elif defined(FOXDBG_MATH_NEON)
+
+    float32x4_t x = vld1q_f32(angle);
+
+    int32x4_t q = vcvtnq_s32_f32(vmulq_n_f32(x, TWO_OVER_PI));
+    float32x4_t j = vcvtq_f32_s32(q);
+    float32x4_t r = vmlsq_n_f32(x, j, PIO2_1);
+    r = vmlsq_n_f32(r, j, PIO2_2);
+    r = vmlsq_n_f32(r, j, PIO2_3);
+
+    float32x4_t r2 = vmulq_f32(r, r);
+
+    float32x4_t ps = vmlaq_n_f32(vdupq_n_f32(SIN_C2), r2, SIN_C3);
+    ps = vmlaq_f32(vdupq_n_f32(SIN_C1), ps, r2);
+    ps = vmlaq_f32(r, vmulq_f32(ps, r2), r);
+
+    float32x4_t pc = vmlaq_n_f32(vdupq_n_f32(COS_C2), r2, COS_C3);
+    pc = vmlaq_f32(vdupq_n_f32(COS_C1), pc, r2);
+    pc = vmulq_f32(vmulq_f32(pc, r2), r2);
+    pc = vaddq_f32(vmlsq_n_f32(pc, r2, 0.5f), vdupq_n_f32(1.0f));
+
+    uint32x4_t swap = vtstq_s32(q, vdupq_n_s32(1));
+    float32x4_t sin_v = vbslq_f32(swap, pc, ps);
+    float32x4_t cos_v = vbslq_f32(swap, ps, pc);
+
+    uint32x4_t sin_sign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(q, vdupq_n_s32(2))), 30);
+    uint32x4_t cos_sign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(vaddq_s32(q, vdupq_n_s32(1)), vdupq_n_s32(2))), 30);
+
+    vst1q_f32(s, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(sin_v), sin_sign)));
+    vst1q_f32(c, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(cos_v), cos_sign)));
+
+#else
+
+    for (size_t k = 0; k < BATCH; k++)
+    {
+        sincos_scalar(angle[k], &s[k], &c[k]);
+    }
+
+#endif
+}
+
+#if defined(FOXDBG_MATH_SCALAR)
+
+static void sincos_scalar(float angle, float *s, float *c)
+{
+    float fj = angle * TWO_OVER_PI;
+    int32_t q = (int32_t)(fj >= 0.0f ? fj + 0.5f : fj - 0.5f);
+    float j = (float)q;
+
+    float r = angle - j * PIO2_1;
+    r = r - j * PIO2_2;
+    r = r - j * PIO2_3;
+
+    float r2 = r * r;
+
+    float ps = ((SIN_C3 * r2 + SIN_C2) * r2 + SIN_C1) * r2 * r + r;
+    float pc = ((COS_C3 * r2 + COS_C2) * r2 + COS_C1) * r2 * r2 - 0.5f * r2 + 1.0f;
+
+    float sin_v = (q & 1) ? pc : ps;
+    float cos_v = (q & 1) ? ps : pc;
+
+    *s = (q & 2) ? -sin_v : sin_v;
+    *c = ((q + 1) & 2) ? -cos_v : cos_v;
+}
+
+#endif
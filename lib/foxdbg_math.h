@@ -0,0 +1,61 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_math.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Math Helpers
+**
+***************************************************************/
+
+#ifndef FOXDBG_MATH_H
+#define FOXDBG_MATH_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "foxdbg_channel.h"
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/* cubes and arrows are drawn with yaw rotated by +90 degrees */
+#define FOXDBG_MARKER_YAW_OFFSET (1.57079632679489661923f)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * convert count euler angles (x pitch, y roll, z yaw, radians) spaced
+ * euler_stride bytes apart into x, y, z, w quaternions. yaw_offset is
+ * added to every yaw.
+ */
+void foxdbg_math_euler_to_quaternion(
+    const foxdbg_vector3_t *euler, size_t euler_stride,
+    float yaw_offset,
+    foxdbg_vector4_t *quaternions, size_t count
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_MATH_H */
@@ -0,0 +1,1041 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_mcap.cpp
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server MCAP Files
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_mcap.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/* record opcodes, see https://mcap.dev/spec */
+#define MCAP_OP_HEADER          (0x01U)
+#define MCAP_OP_FOOTER          (0x02U)
+#define MCAP_OP_SCHEMA          (0x03U)
+#define MCAP_OP_CHANNEL         (0x04U)
+#define MCAP_OP_MESSAGE         (0x05U)
+#define MCAP_OP_CHUNK           (0x06U)
+#define MCAP_OP_MESSAGE_INDEX   (0x07U)
+#define MCAP_OP_CHUNK_INDEX     (0x08U)
+#define MCAP_OP_STATISTICS      (0x0BU)
+#define MCAP_OP_SUMMARY_OFFSET  (0x0EU)
+#define MCAP_OP_DATA_END        (0x0FU)
+
+#define FILE_BUFFER_SIZE (1024U * 1024U)
+
+#define MCAP_MAGIC_SIZE         (8U)
+#define MCAP_RECORD_HEADER_SIZE (9U)     /* opcode, u64 length */
+#define MCAP_FOOTER_SIZE        (MCAP_RECORD_HEADER_SIZE + 20U)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+typedef struct
+{
+    uint64_t log_time;
+    uint64_t offset;        /* within the chunk's records */
+} index_entry_t;
+
+typedef struct
+{
+    uint64_t message_start_time;
+    uint64_t message_end_time;
+    uint64_t chunk_start_offset;
+    uint64_t chunk_length;
+    std::map<uint16_t, uint64_t> message_index_offsets;
+    uint64_t message_index_length;
+    uint64_t records_size;
+} chunk_index_t;
+
+typedef struct
+{
+    uint32_t sequence;
+    uint64_t message_count;
+} channel_stats_t;
+
+struct foxdbg_mcap_writer
+{
+    FILE *file;
+    uint64_t file_offset;
+
+    std::vector<uint8_t> chunk;
+    std::map<uint16_t, std::vector<index_entry_t>> chunk_message_index;
+    uint64_t chunk_start_time;
+    uint64_t chunk_end_time;
+
+    std::vector<chunk_index_t> chunk_indexes;
+    std::map<std::string, uint16_t> schema_ids;
+    std::map<uint16_t, std::vector<uint8_t>> schema_records;   /* content, repeated in the summary */
+    std::map<uint16_t, std::vector<uint8_t>> channel_records;
+    std::map<uint16_t, channel_stats_t> channel_stats;
+
+    uint64_t message_count;
+    uint64_t message_start_time;
+    uint64_t message_end_time;
+};
+
+typedef struct
+{
+    uint64_t message_start_time;
+    uint64_t message_end_time;
+    uint64_t offset;        /* of the chunk record */
+} chunk_entry_t;
+
+typedef struct
+{
+    std::string name;
+    std::string encoding;
+    const uint8_t *data;
+    size_t size;
+} schema_entry_t;
+
+typedef struct
+{
+    uint16_t schema_id;
+    std::string topic;
+    std::string message_encoding;
+} channel_entry_t;
+
+/* bounds checked little endian reads over part of the mapped file */
+typedef struct
+{
+    const uint8_t *data;
+    size_t size;
+    size_t offset;
+    bool ok;
+} cursor_t;
+
+struct foxdbg_mcap_reader
+{
+    const uint8_t *data;
+    size_t size;
+
+    #ifdef WIN32
+        HANDLE file;
+        HANDLE mapping;
+    #endif
+
+    std::map<uint16_t, schema_entry_t> schemas;
+    std::map<uint16_t, channel_entry_t> channel_entries;
+    std::vector<foxdbg_mcap_channel_t> channels;
+
+    std::vector<chunk_entry_t> chunks;  /* by start time */
+    uint64_t start_time;
+    uint64_t end_time;
+
+    /* messages of the chunk being read, by log time */
+    std::vector<foxdbg_mcap_message_t> messages;
+    size_t next_message;
+    size_t next_chunk;
+};
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static void flush_chunk(foxdbg_mcap_writer_t *writer);
+static void write_summary(foxdbg_mcap_writer_t *writer);
+
+static void write_bytes(foxdbg_mcap_writer_t *writer, const void *data, size_t size);
+static void write_record(foxdbg_mcap_writer_t *writer, uint8_t opcode, const std::vector<uint8_t> &content);
+
+static bool map_file(foxdbg_mcap_reader_t *reader, const char *path);
+static void unmap_file(foxdbg_mcap_reader_t *reader);
+static bool read_summary(foxdbg_mcap_reader_t *reader);
+static void scan_records(foxdbg_mcap_reader_t *reader);
+static void read_definition(foxdbg_mcap_reader_t *reader, uint8_t opcode, cursor_t content);
+static bool read_chunk_header(cursor_t *chunk, chunk_entry_t *entry, cursor_t *records, bool *compressed);
+static void load_chunk(foxdbg_mcap_reader_t *reader, size_t index);
+
+static cursor_t make_cursor(const uint8_t *data, size_t size);
+static bool next_record(cursor_t *cursor, uint8_t *opcode, cursor_t *content);
+static uint16_t get_u16(cursor_t *cursor);
+static uint32_t get_u32(cursor_t *cursor);
+static uint64_t get_u64(cursor_t *cursor);
+static const uint8_t *get_bytes(cursor_t *cursor, size_t size);
+static std::string get_string(cursor_t *cursor);
+
+static void put_u16(std::vector<uint8_t> &out, uint16_t value);
+static void put_u32(std::vector<uint8_t> &out, uint32_t value);
+static void put_u64(std::vector<uint8_t> &out, uint64_t value);
+static void put_string(std::vector<uint8_t> &out, const char *value);
+static void put_record(std::vector<uint8_t> &out, uint8_t opcode, const std::vector<uint8_t> &content);
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+static const uint8_t mcap_magic[8] = { 0x89, 'M', 'C', 'A', 'P', '0', '\r', '\n' };
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+foxdbg_mcap_writer_t *foxdbg_mcap_writer_open(const char *path)
+{
+    FILE *file = fopen(path, "wb");
+
+    if (!file)
+    {
+        fprintf(stderr, "FOXDBG: cannot create %s\n", path);
+        return NULL;
+    }
+
+    setvbuf(file, NULL, _IOFBF, FILE_BUFFER_SIZE);
+
+    foxdbg_mcap_writer_t *writer = new foxdbg_mcap_writer_t();
+    writer->file = file;
+    writer->file_offset = 0;
+    writer->chunk_start_time = 0;
+    writer->chunk_end_time = 0;
+    writer->message_count = 0;
+    writer->message_start_time = 0;
+    writer->message_end_time = 0;
+
+    write_bytes(writer, mcap_magic, sizeof(mcap_magic));
+
+    std::vector<uint8_t> header;
+    put_string(header, "");         /* profile */
+    put_string(header, "foxdbg");   /* library */
+    write_record(writer, MCAP_OP_HEADER, header);
+
+    return writer;
+}
+
+void foxdbg_mcap_writer_write(
+    foxdbg_mcap_writer_t *writer,
+    int channel_id, const char *topic, const char *schema_name, const char *schema,
+    uint64_t log_time, uint64_t publish_time,
+    const uint8_t *data, size_t size)
+{
+    uint16_t id = (uint16_t)channel_id;
+
+    /* schema and channel go into the chunk ahead of the channel's first message */
+    if (writer->channel_records.find(id) == writer->channel_records.end())
+    {
+        auto found = writer->schema_ids.find(schema_name);
+
+        if (found == writer->schema_ids.end())
+        {
+            uint16_t schema_id = (uint16_t)(writer->schema_ids.size() + 1); /* 0 means no schema */
+
+            /* same schema as advertised to the websocket, readers know the foxglove ones by name */
+            std::vector<uint8_t> content;
+            put_u16(content, schema_id);
+            put_string(content, schema_name);
+            put_string(content, "jsonschema");
+            put_string(content, schema[0] ? schema : "{}");
+
+            put_record(writer->chunk, MCAP_OP_SCHEMA, content);
+            writer->schema_records[schema_id] = std::move(content);
+            found = writer->schema_ids.emplace(schema_name, schema_id).first;
+        }
+
+        std::vector<uint8_t> content;
+        put_u16(content, id);
+        put_u16(content, found->second);
+        put_string(content, topic);
+        put_string(content, "json");
+        put_u32(content, 0); /* metadata */
+
+        put_record(writer->chunk, MCAP_OP_CHANNEL, content);
+        writer->channel_records[id] = std::move(content);
+        writer->channel_stats[id] = { 0, 0 };
+    }
+
+    channel_stats_t &stats = writer->channel_stats[id];
+
+    if (writer->chunk_message_index.empty())
+    {
+        writer->chunk_start_time = log_time;
+        writer->chunk_end_time = log_time;
+    }
+
+    writer->chunk_message_index[id].push_back({ log_time, (uint64_t)writer->chunk.size() });
+
+    /* message record, written straight into the chunk to avoid another copy */
+    std::vector<uint8_t> &chunk = writer->chunk;
+    chunk.push_back(MCAP_OP_MESSAGE);
+    put_u64(chunk, 2 + 4 + 8 + 8 + size);
+    put_u16(chunk, id);
+    put_u32(chunk, stats.sequence++);
+    put_u64(chunk, log_time);
+    put_u64(chunk, publish_time);
+    chunk.insert(chunk.end(), data, data + size);
+
+    stats.message_count++;
+
+    if (log_time < writer->chunk_start_time) writer->chunk_start_time = log_time;
+    if (log_time > writer->chunk_end_time) writer->chunk_end_time = log_time;
+
+    if (writer->message_count == 0 || log_time < writer->message_start_time) writer->message_start_time = log_time;
+    if (writer->message_count == 0 || log_time > writer->message_end_time) writer->message_end_time = log_time;
+    writer->message_count++;
+
+    if (chunk.size() >= FOXDBG_MCAP_CHUNK_SIZE)
+    {
+        flush_chunk(writer);
+    }
+}
+
+uint64_t foxdbg_mcap_writer_close(foxdbg_mcap_writer_t *writer)
+{
+    flush_chunk(writer);
+
+    std::vector<uint8_t> data_end;
+    put_u32(data_end, 0); /* data section crc not computed */
+    write_record(writer, MCAP_OP_DATA_END, data_end);
+
+    write_summary(writer);
+
+    write_bytes(writer, mcap_magic, sizeof(mcap_magic));
+
+    fclose(writer->file);
+
+    uint64_t message_count = writer->message_count;
+    delete writer;
+
+    return message_count;
+}
+
+foxdbg_mcap_reader_t *foxdbg_mcap_reader_open(const char *path)
+{
+    foxdbg_mcap_reader_t *reader = new foxdbg_mcap_reader_t();
+
+    if (!map_file(reader, path))
+    {
+        fprintf(stderr, "FOXDBG: cannot map %s\n", path);
+        delete reader;
+        return NULL;
+    }
+
+    if (reader->size < 2 * MCAP_MAGIC_SIZE || memcmp(reader->data, mcap_magic, MCAP_MAGIC_SIZE) != 0)
+    {
+        fprintf(stderr, "FOXDBG: %s is not an MCAP file\n", path);
+        foxdbg_mcap_reader_close(reader);
+        return NULL;
+    }
+
+    /* a recording cut short has no summary, find the chunks the slow way */
+    if (!read_summary(reader))
+    {
+        reader->schemas.clear();
+        reader->channel_entries.clear();
+        reader->chunks.clear();
+
+        scan_records(reader);
+    }
+
+    std::stable_sort(reader->chunks.begin(), reader->chunks.end(),
+        [](const chunk_entry_t &a, const chunk_entry_t &b) { return a.message_start_time < b.message_start_time; });
+
+    reader->start_time = 0;
+    reader->end_time = 0;
+
+    for (size_t i = 0; i < reader->chunks.size(); ++i)
+    {
+        const chunk_entry_t &chunk = reader->chunks[i];
+
+        if (i == 0 || chunk.message_start_time < reader->start_time) reader->start_time = chunk.message_start_time;
+        if (i == 0 || chunk.message_end_time > reader->end_time) reader->end_time = chunk.message_end_time;
+    }
+
+    for (const auto &entry : reader->channel_entries)
+    {
+        auto schema = reader->schemas.find(entry.second.schema_id);
+
+        foxdbg_mcap_channel_t channel;
+        channel.id = entry.first;
+        channel.topic = entry.second.topic.c_str();
+        channel.message_encoding = entry.second.message_encoding.c_str();
+        channel.schema_name = schema != reader->schemas.end() ? schema->second.name.c_str() : "";
+        channel.schema_encoding = schema != reader->schemas.end() ? schema->second.encoding.c_str() : "";
+        channel.schema = schema != reader->schemas.end() ? schema->second.data : NULL;
+        channel.schema_size = schema != reader->schemas.end() ? schema->second.size : 0;
+
+        reader->channels.push_back(channel);
+    }
+
+    reader->next_message = 0;
+    reader->next_chunk = 0;
+
+    return reader;
+}
+
+void foxdbg_mcap_reader_close(foxdbg_mcap_reader_t *reader)
+{
+    unmap_file(reader);
+    delete reader;
+}
+
+size_t foxdbg_mcap_reader_channel_count(const foxdbg_mcap_reader_t *reader)
+{
+    return reader->channels.size();
+}
+
+const foxdbg_mcap_channel_t *foxdbg_mcap_reader_channel(const foxdbg_mcap_reader_t *reader, size_t index)
+{
+    return index < reader->channels.size() ? &reader->channels[index] : NULL;
+}
+
+uint64_t foxdbg_mcap_reader_start_time(const foxdbg_mcap_reader_t *reader)
+{
+    return reader->start_time;
+}
+
+uint64_t foxdbg_mcap_reader_end_time(const foxdbg_mcap_reader_t *reader)
+{
+    return reader->end_time;
+}
+
+void foxdbg_mcap_reader_seek(foxdbg_mcap_reader_t *reader, uint64_t log_time)
+{
+    reader->messages.clear();
+    reader->next_message = 0;
+    reader->next_chunk = reader->chunks.size();
+
+    /* only chunks reaching log_time need to be opened */
+    for (size_t i = 0; i < reader->chunks.size(); ++i)
+    {
+        if (reader->chunks[i].message_end_time >= log_time)
+        {
+            load_chunk(reader, i);
+            reader->next_chunk = i + 1;
+            break;
+        }
+    }
+
+    auto first = std::lower_bound(reader->messages.begin(), reader->messages.end(), log_time,
+        [](const foxdbg_mcap_message_t &message, uint64_t time) { return message.log_time < time; });
+
+    reader->next_message = (size_t)(first - reader->messages.begin());
+}
+
+bool foxdbg_mcap_reader_next(foxdbg_mcap_reader_t *reader, foxdbg_mcap_message_t *message)
+{
+    while (reader->next_message >= reader->messages.size())
+    {
+        if (reader->next_chunk >= reader->chunks.size())
+        {
+            return false;
+        }
+
+        load_chunk(reader, reader->next_chunk++);
+    }
+
+    *message = reader->messages[reader->next_message++];
+    return true;
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+/* write the chunk, then one message index per channel in it */
+static void flush_chunk(foxdbg_mcap_writer_t *writer)
+{
+    if (writer->chunk_message_index.empty())
+    {
+        return;
+    }
+
+    std::vector<uint8_t> &chunk = writer->chunk;
+
+    chunk_index_t index;
+    index.message_start_time = writer->chunk_start_time;
+    index.message_end_time = writer->chunk_end_time;
+    index.chunk_start_offset = writer->file_offset;
+    index.records_size = chunk.size();
+
+    std::vector<uint8_t> header;
+    put_u64(header, writer->chunk_start_time);
+    put_u64(header, writer->chunk_end_time);
+    put_u64(header, chunk.size());      /* uncompressed size */
+    put_u32(header, 0);                 /* crc not computed */
+    put_string(header, "");             /* no compression */
+    put_u64(header, chunk.size());
+
+    uint8_t opcode = MCAP_OP_CHUNK;
+    std::vector<uint8_t> length;
+    put_u64(length, header.size() + chunk.size());
+
+    write_bytes(writer, &opcode, 1);
+    write_bytes(writer, length.data(), length.size());
+    write_bytes(writer, header.data(), header.size());
+    write_bytes(writer, chunk.data(), chunk.size());
+
+    index.chunk_length = writer->file_offset - index.chunk_start_offset;
+
+    uint64_t message_index_start = writer->file_offset;
+
+    for (const auto &channel : writer->chunk_message_index)
+    {
+        index.message_index_offsets[channel.first] = writer->file_offset;
+
+        std::vector<uint8_t> content;
+        put_u16(content, channel.first);
+        put_u32(content, (uint32_t)(channel.second.size() * 16));
+
+        for (const index_entry_t &entry : channel.second)
+        {
+            put_u64(content, entry.log_time);
+            put_u64(content, entry.offset);
+        }
+
+        write_record(writer, MCAP_OP_MESSAGE_INDEX, content);
+    }
+
+    index.message_index_length = writer->file_offset - message_index_start;
+
+    writer->chunk_indexes.push_back(std::move(index));
+
+    chunk.clear();
+    writer->chunk_message_index.clear();
+}
+
+/* summary groups, then a summary offset pointing at each and the footer */
+static void write_summary(foxdbg_mcap_writer_t *writer)
+{
+    uint64_t summary_start = writer->file_offset;
+
+    std::vector<std::vector<uint8_t>> summary_offsets;
+
+    auto end_group = [&](uint8_t opcode, uint64_t group_start)
+    {
+        if (writer->file_offset == group_start)
+        {
+            return;
+        }
+
+        std::vector<uint8_t> content;
+        content.push_back(opcode);
+        put_u64(content, group_start);
+        put_u64(content, writer->file_offset - group_start);
+        summary_offsets.push_back(std::move(content));
+    };
+
+    uint64_t group_start = writer->file_offset;
+    for (const auto &schema : writer->schema_records)
+    {
+        write_record(writer, MCAP_OP_SCHEMA, schema.second);
+    }
+    end_group(MCAP_OP_SCHEMA, group_start);
+
+    group_start = writer->file_offset;
+    for (const auto &channel : writer->channel_records)
+    {
+        write_record(writer, MCAP_OP_CHANNEL, channel.second);
+    }
+    end_group(MCAP_OP_CHANNEL, group_start);
+
+    group_start = writer->file_offset;
+    {
+        std::vector<uint8_t> content;
+        put_u64(content, writer->message_count);
+        put_u16(content, (uint16_t)writer->schema_records.size());
+        put_u32(content, (uint32_t)writer->channel_records.size());
+        put_u32(content, 0); /* attachments */
+        put_u32(content, 0); /* metadata */
+        put_u32(content, (uint32_t)writer->chunk_indexes.size());
+        put_u64(content, writer->message_start_time);
+        put_u64(content, writer->message_end_time);
+        put_u32(content, (uint32_t)(writer->channel_stats.size() * 10));
+
+        for (const auto &channel : writer->channel_stats)
+        {
+            put_u16(content, channel.first);
+            put_u64(content, channel.second.message_count);
+        }
+
+        write_record(writer, MCAP_OP_STATISTICS, content);
+    }
+    end_group(MCAP_OP_STATISTICS, group_start);
+
+    group_start = writer->file_offset;
+    for (const chunk_index_t &index : writer->chunk_indexes)
+    {
+        std::vector<uint8_t> content;
+        put_u64(content, index.message_start_time);
+        put_u64(content, index.message_end_time);
+        put_u64(content, index.chunk_start_offset);
+        put_u64(content, index.chunk_length);
+        put_u32(content, (uint32_t)(index.message_index_offsets.size() * 10));
+
+        for (const auto &offset : index.message_index_offsets)
+        {
+            put_u16(content, offset.first);
+            put_u64(content, offset.second);
+        }
+
+        put_u64(content, index.message_index_length);
+        put_string(content, "");
+        put_u64(content, index.records_size); /* compressed size */
+        put_u64(content, index.records_size); /* uncompressed size */
+
+        write_record(writer, MCAP_OP_CHUNK_INDEX, content);
+    }
+    end_group(MCAP_OP_CHUNK_INDEX, group_start);
+
+    uint64_t summary_offset_start = writer->file_offset;
+
+    for (const std::vector<uint8_t> &offset : summary_offsets)
+    {
+        write_record(writer, MCAP_OP_SUMMARY_OFFSET, offset);
+    }
+
+    std::vector<uint8_t> footer;
+    put_u64(footer, summary_start);
+    put_u64(footer, summary_offset_start);
+    put_u32(footer, 0); /* summary crc not computed */
+    write_record(writer, MCAP_OP_FOOTER, footer);
+}
+
+#ifdef WIN32
+    static bool map_file(foxdbg_mcap_reader_t *reader, const char *path)
+    {
+        reader->data = NULL;
+        reader->size = 0;
+        reader->mapping = NULL;
+        reader->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+        if (reader->file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER size;
+
+        if (!GetFileSizeEx(reader->file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(reader->file);
+            return false;
+        }
+
+        reader->mapping = CreateFileMappingA(reader->file, NULL, PAGE_READONLY, 0, 0, NULL);
+        reader->data = reader->mapping ? (const uint8_t *)MapViewOfFile(reader->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+
+        if (!reader->data)
+        {
+            if (reader->mapping) CloseHandle(reader->mapping);
+            CloseHandle(reader->file);
+            return false;
+        }
+
+        reader->size = (size_t)size.QuadPart;
+        return true;
+    }
+
+    static void unmap_file(foxdbg_mcap_reader_t *reader)
+    {
+        UnmapViewOfFile(reader->data);
+        CloseHandle(reader->mapping);
+        CloseHandle(reader->file);
+    }
+
+#else
+
+    static bool map_file(foxdbg_mcap_reader_t *reader, const char *path)
+    {
+        reader->data = NULL;
+        reader->size = 0;
+
+        int fd = open(path, O_RDONLY);
+
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat st;
+
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); /* the mapping keeps the file */
+
+        if (data == MAP_FAILED)
+        {
+            return false;
+        }
+
+        /* playback reads forward through the chunks */
+        madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+        reader->data = (const uint8_t *)data;
+        reader->size = (size_t)st.st_size;
+        return true;
+    }
+
+    static void unmap_file(foxdbg_mcap_reader_t *reader)
+    {
+        munmap((void *)reader->data, reader->size);
+    }
+#endif
+
+/* definitions and chunk index from the summary, false if the file has none */
+static bool read_summary(foxdbg_mcap_reader_t *reader)
+{
+    if (reader->size < 2 * MCAP_MAGIC_SIZE + MCAP_FOOTER_SIZE ||
+        memcmp(reader->data + reader->size - MCAP_MAGIC_SIZE, mcap_magic, MCAP_MAGIC_SIZE) != 0)
+    {
+        return false;
+    }
+
+    size_t footer_offset = reader->size - MCAP_MAGIC_SIZE - MCAP_FOOTER_SIZE;
+    cursor_t footer = make_cursor(reader->data + footer_offset, MCAP_FOOTER_SIZE);
+
+    uint8_t opcode;
+    cursor_t content;
+
+    if (!next_record(&footer, &opcode, &content) || opcode != MCAP_OP_FOOTER)
+    {
+        return false;
+    }
+
+    uint64_t summary_start = get_u64(&content);
+
+    if (!content.ok || summary_start == 0 || summary_start >= footer_offset)
+    {
+        return false;
+    }
+
+    cursor_t summary = make_cursor(reader->data + summary_start, footer_offset - summary_start);
+
+    while (next_record(&summary, &opcode, &content))
+    {
+        if (opcode == MCAP_OP_CHUNK_INDEX)
+        {
+            chunk_entry_t entry;
+            entry.message_start_time = get_u64(&content);
+            entry.message_end_time = get_u64(&content);
+            entry.offset = get_u64(&content);
+
+            if (content.ok && entry.offset < reader->size)
+            {
+                reader->chunks.push_back(entry);
+            }
+        }
+        else
+        {
+            read_definition(reader, opcode, content);
+        }
+    }
+
+    return !reader->chunks.empty();
+}
+
+/* walk the data section, reading definitions out of every chunk */
+static void scan_records(foxdbg_mcap_reader_t *reader)
+{
+    cursor_t file = make_cursor(reader->data + MCAP_MAGIC_SIZE, reader->size - MCAP_MAGIC_SIZE);
+
+    uint8_t opcode;
+    cursor_t content;
+
+    while (next_record(&file, &opcode, &content))
+    {
+        if (opcode == MCAP_OP_DATA_END)
+        {
+            break;
+        }
+
+        if (opcode != MCAP_OP_CHUNK)
+        {
+            read_definition(reader, opcode, content);
+            continue;
+        }
+
+        chunk_entry_t entry;
+        cursor_t records;
+        bool compressed;
+
+        if (!read_chunk_header(&content, &entry, &records, &compressed) || compressed)
+        {
+            continue;
+        }
+
+        entry.offset = (uint64_t)(content.data - MCAP_RECORD_HEADER_SIZE - reader->data);
+        reader->chunks.push_back(entry);
+
+        cursor_t record;
+
+        while (next_record(&records, &opcode, &record))
+        {
+            read_definition(reader, opcode, record);
+        }
+    }
+}
+
+/* keep schema and channel records, ignore everything else */
+static void read_definition(foxdbg_mcap_reader_t *reader, uint8_t opcode, cursor_t content)
+{
+    if (opcode == MCAP_OP_SCHEMA)
+    {
+        uint16_t id = get_u16(&content);
+
+        schema_entry_t schema;
+        schema.name = get_string(&content);
+        schema.encoding = get_string(&content);
+        schema.size = get_u32(&content);
+        schema.data = get_bytes(&content, schema.size);
+
+        if (content.ok)
+        {
+            reader->schemas[id] = schema;
+        }
+    }
+    else if (opcode == MCAP_OP_CHANNEL)
+    {
+        uint16_t id = get_u16(&content);
+
+        channel_entry_t channel;
+        channel.schema_id = get_u16(&content);
+        channel.topic = get_string(&content);
+        channel.message_encoding = get_string(&content);
+
+        if (content.ok)
+        {
+            reader->channel_entries[id] = channel;
+        }
+    }
+}
+
+static bool read_chunk_header(cursor_t *chunk, chunk_entry_t *entry, cursor_t *records, bool *compressed)
+{
+    entry->message_start_time = get_u64(chunk);
+    entry->message_end_time = get_u64(chunk);
+    get_u64(chunk); /* uncompressed size */
+    get_u32(chunk); /* crc */
+
+    *compressed = !get_string(chunk).empty();
+
+    uint64_t records_size = get_u64(chunk);
+    const uint8_t *data = get_bytes(chunk, records_size);
+
+    *records = make_cursor(data, chunk->ok ? records_size : 0);
+
+    return chunk->ok;
+}
+
+static void load_chunk(foxdbg_mcap_reader_t *reader, size_t index)
+{
+    reader->messages.clear();
+    reader->next_message = 0;
+
+    cursor_t file = make_cursor(reader->data + reader->chunks[index].offset, reader->size - reader->chunks[index].offset);
+
+    uint8_t opcode;
+    cursor_t content;
+
+    if (!next_record(&file, &opcode, &content) || opcode != MCAP_OP_CHUNK)
+    {
+        return;
+    }
+
+    chunk_entry_t entry;
+    cursor_t records;
+    bool compressed;
+
+    if (!read_chunk_header(&content, &entry, &records, &compressed))
+    {
+        return;
+    }
+
+    if (compressed)
+    {
+        fprintf(stderr, "FOXDBG: skipping compressed MCAP chunk\n");
+        return;
+    }
+
+    while (next_record(&records, &opcode, &content))
+    {
+        if (opcode != MCAP_OP_MESSAGE)
+        {
+            continue;
+        }
+
+        foxdbg_mcap_message_t message;
+        message.channel_id = get_u16(&content);
+        get_u32(&content); /* sequence */
+        message.log_time = get_u64(&content);
+        message.publish_time = get_u64(&content);
+        message.size = content.size - content.offset;
+        message.data = get_bytes(&content, message.size);
+
+        if (content.ok)
+        {
+            reader->messages.push_back(message);
+        }
+    }
+
+    /* recordings are written in arrival order, capture times can be out of order */
+    std::stable_sort(reader->messages.begin(), reader->messages.end(),
+        [](const foxdbg_mcap_message_t &a, const foxdbg_mcap_message_t &b) { return a.log_time < b.log_time; });
+}
+
+static cursor_t make_cursor(const uint8_t *data, size_t size)
+{
+    cursor_t cursor = { data, size, 0, true };
+    return cursor;
+}
+
+/* split off the next whole record, false at the end or on a truncated one */
+static bool next_record(cursor_t *cursor, uint8_t *opcode, cursor_t *content)
+{
+    if (cursor->size - cursor->offset < MCAP_RECORD_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    cursor_t header = make_cursor(cursor->data + cursor->offset, MCAP_RECORD_HEADER_SIZE);
+    header.offset = 1;
+    uint64_t length = get_u64(&header);
+
+    if (length > cursor->size - cursor->offset - MCAP_RECORD_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    *opcode = cursor->data[cursor->offset];
+    *content = make_cursor(cursor->data + cursor->offset + MCAP_RECORD_HEADER_SIZE, (size_t)length);
+
+    cursor->offset += MCAP_RECORD_HEADER_SIZE + (size_t)length;
+    return true;
+}
+
+static uint16_t get_u16(cursor_t *cursor)
+{
+    const uint8_t *p = get_bytes(cursor, 2);
+    return p ? (uint16_t)(p[0] | (p[1] << 8)) : 0;
+}
+
+static uint32_t get_u32(cursor_t *cursor)
+{
+    const uint8_t *p = get_bytes(cursor, 4);
+    uint32_t value = 0;
+
+    for (int i = 0; p && i < 4; ++i)
+    {
+        value |= (uint32_t)p[i] << (8 * i);
+    }
+
+    return value;
+}
+
+static uint64_t get_u64(cursor_t *cursor)
+{
+    const uint8_t *p = get_bytes(cursor, 8);
+    uint64_t value = 0;
+
+    for (int i = 0; p && i < 8; ++i)
+    {
+        value |= (uint64_t)p[i] << (8 * i);
+    }
+
+    return value;
+}
+
+static const uint8_t *get_bytes(cursor_t *cursor, size_t size)
+{
+    if (!cursor->ok || size > cursor->size - cursor->offset)
+    {
+        cursor->ok = false;
+        return NULL;
+    }
+
+    const uint8_t *p = cursor->data + cursor->offset;
+    cursor->offset += size;
+    return p;
+}
+
+static std::string get_string(cursor_t *cursor)
+{
+    uint32_t length = get_u32(cursor);
+    const uint8_t *p = get_bytes(cursor, length);
+
+    return p ? std::string((const char *)p, length) : std::string();
+}
+
+static void write_bytes(foxdbg_mcap_writer_t *writer, const void *data, size_t size)
+{
+    fwrite(data, 1, size, writer->file);
+    writer->file_offset += size;
+}
+
+static void write_record(foxdbg_mcap_writer_t *writer, uint8_t opcode, const std::vector<uint8_t> &content)
+{
+    std::vector<uint8_t> record;
+    put_record(record, opcode, content);
+    write_bytes(writer, record.data(), record.size());
+}
+
+static void put_u16(std::vector<uint8_t> &out, uint16_t value)
+{
+    out.push_back((uint8_t)(value & 0xFF));
+    out.push_back((uint8_t)(value >> 8));
+}
+
+static void put_u32(std::vector<uint8_t> &out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        out.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+static void put_u64(std::vector<uint8_t> &out, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        out.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+static void put_string(std::vector<uint8_t> &out, const char *value)
+{
+    size_t length = strlen(value);
+    put_u32(out, (uint32_t)length);
+    out.insert(out.end(), value, value + length);
+}
+
+static void put_record(std::vector<uint8_t> &out, uint8_t opcode, const std::vector<uint8_t> &content)
+{
+    out.push_back(opcode);
+    put_u64(out, content.size());
+    out.insert(out.end(), content.begin(), content.end());
+}
@@ -0,0 +1,113 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_mcap.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server MCAP Files
+**
+***************************************************************/
+
+#ifndef FOXDBG_MCAP_H
+#define FOXDBG_MCAP_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/* uncompressed records per chunk before it is written out */
+#define FOXDBG_MCAP_CHUNK_SIZE (4U * 1024U * 1024U)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+typedef struct foxdbg_mcap_writer foxdbg_mcap_writer_t;
+typedef struct foxdbg_mcap_reader foxdbg_mcap_reader_t;
+
+typedef struct
+{
+    uint16_t id;
+    const char *topic;
+    const char *message_encoding;
+    const char *schema_name;
+    const char *schema_encoding;
+    const uint8_t *schema;
+    size_t schema_size;
+} foxdbg_mcap_channel_t;
+
+/* points into the mapped file, valid until the reader is closed */
+typedef struct
+{
+    uint16_t channel_id;
+    uint64_t log_time;
+    uint64_t publish_time;
+    const uint8_t *data;
+    size_t size;
+} foxdbg_mcap_message_t;
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* create path and write the file header, NULL if it cannot be created */
+foxdbg_mcap_writer_t *foxdbg_mcap_writer_open(const char *path);
+
+/*
+ * append one json message. the channel and its schema are added to the
+ * file the first time they are seen, schema may be empty for well known
+ * schema names.
+ */
+void foxdbg_mcap_writer_write(
+    foxdbg_mcap_writer_t *writer,
+    int channel_id, const char *topic, const char *schema_name, const char *schema,
+    uint64_t log_time, uint64_t publish_time,
+    const uint8_t *data, size_t size
+);
+
+/* write the last chunk, the summary and footer, close the file. returns the message count */
+uint64_t foxdbg_mcap_writer_close(foxdbg_mcap_writer_t *writer);
+
+/*
+ * map path and read its channels and chunk index, from the summary or by
+ * scanning the file if it was never finished. NULL if it is not an MCAP
+ * file. only uncompressed chunks are read.
+ */
+foxdbg_mcap_reader_t *foxdbg_mcap_reader_open(const char *path);
+
+void foxdbg_mcap_reader_close(foxdbg_mcap_reader_t *reader);
+
+size_t foxdbg_mcap_reader_channel_count(const foxdbg_mcap_reader_t *reader);
+
+const foxdbg_mcap_channel_t *foxdbg_mcap_reader_channel(const foxdbg_mcap_reader_t *reader, size_t index);
+
+/* log time of the first and last message */
+uint64_t foxdbg_mcap_reader_start_time(const foxdbg_mcap_reader_t *reader);
+uint64_t foxdbg_mcap_reader_end_time(const foxdbg_mcap_reader_t *reader);
+
+/* continue from the first message logged at or after log_time */
+void foxdbg_mcap_reader_seek(foxdbg_mcap_reader_t *reader, uint64_t log_time);
+
+/* next message in log time order within each chunk, false at the end */
+bool foxdbg_mcap_reader_next(foxdbg_mcap_reader_t *reader, foxdbg_mcap_message_t *message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_MCAP_H */
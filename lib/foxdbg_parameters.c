@@ -0,0 +1,296 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_parameters.c
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Parameter Store
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_parameters.h"
+#include "foxdbg_atomic.h"
+
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+#ifdef _WIN32
+    #define PARAMETERS_LOCK() AcquireSRWLockExclusive(&parameters_lock)
+    #define PARAMETERS_UNLOCK() ReleaseSRWLockExclusive(&parameters_lock)
+#else
+    #define PARAMETERS_LOCK() pthread_mutex_lock(&parameters_lock)
+    #define PARAMETERS_UNLOCK() pthread_mutex_unlock(&parameters_lock)
+#endif
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+typedef struct
+{
+    char name[FOXDBG_PARAMETER_NAME_LENGTH];
+    foxdbg_parameter_type_t type;
+    uint64_t value;     /* bits of the double, accessed atomically */
+    uint32_t version;
+} parameter_t;
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static int find_parameter(const char *name, int count);
+static bool valid_parameters(const int *ids, size_t count);
+static uint64_t convert_value(foxdbg_parameter_type_t type, double value);
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+/* names and types are written once before parameter_count is published */
+static parameter_t parameters[FOXDBG_MAX_PARAMETERS];
+static int parameter_count = 0;
+
+/* seqlock over the values, odd while a group is being written */
+static uint32_t sequence = 0;
+
+/* serialises writers, readers never take it */
+#ifdef _WIN32
+static SRWLOCK parameters_lock = SRWLOCK_INIT;
+#else
+static pthread_mutex_t parameters_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+int foxdbg_parameters_add(const char *name, foxdbg_parameter_type_t type, double value)
+{
+    if (!name)
+    {
+        return -1;
+    }
+
+    PARAMETERS_LOCK();
+
+    int count = parameter_count;
+    int parameter = -1;
+
+    if (find_parameter(name, count) < 0 && count < (int)FOXDBG_MAX_PARAMETERS)
+    {
+        parameter = count;
+
+        strncpy(parameters[parameter].name, name, FOXDBG_PARAMETER_NAME_LENGTH - 1);
+        parameters[parameter].name[FOXDBG_PARAMETER_NAME_LENGTH - 1] = '\0';
+        parameters[parameter].type = type;
+        parameters[parameter].version = 0;
+        ATOMIC_WRITE_U64(&parameters[parameter].value, convert_value(type, value));
+
+        ATOMIC_WRITE_INT(&parameter_count, count + 1);
+    }
+
+    PARAMETERS_UNLOCK();
+
+    return parameter;
+}
+
+int foxdbg_parameters_find(const char *name)
+{
+    if (!name)
+    {
+        return -1;
+    }
+
+    return find_parameter(name, ATOMIC_READ_INT(&parameter_count));
+}
+
+int foxdbg_parameters_count(void)
+{
+    return ATOMIC_READ_INT(&parameter_count);
+}
+
+const char *foxdbg_parameters_name(int parameter)
+{
+    if (parameter < 0 || parameter >= ATOMIC_READ_INT(&parameter_count))
+    {
+        return NULL;
+    }
+
+    return parameters[parameter].name;
+}
+
+foxdbg_parameter_type_t foxdbg_parameters_type(int parameter)
+{
+    if (parameter < 0 || parameter >= ATOMIC_READ_INT(&parameter_count))
+    {
+        return FOXDBG_PARAMETER_TYPE_FLOAT;
+    }
+
+    return parameters[parameter].type;
+}
+
+double foxdbg_parameters_read(int parameter)
+{
+    if (parameter < 0 || parameter >= ATOMIC_READ_INT(&parameter_count))
+    {
+        return 0.0;
+    }
+
+    uint64_t bits = ATOMIC_READ_U64(&parameters[parameter].value);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+bool foxdbg_parameters_read_group(const int *ids, double *values, size_t count)
+{
+    if (!valid_parameters(ids, count))
+    {
+        return false;
+    }
+
+    while (true)
+    {
+        uint32_t before = ATOMIC_READ_INT(&sequence);
+
+        if (before & 1U)
+        {
+            YIELD_CPU(); /* a group is half written */
+            continue;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            uint64_t bits = ATOMIC_READ_U64(&parameters[ids[i]].value);
+            memcpy(&values[i], &bits, sizeof(values[i]));
+        }
+
+        if (ATOMIC_READ_INT(&sequence) == before)
+        {
+            return true;
+        }
+    }
+}
+
+bool foxdbg_parameters_write_group(const int *ids, const double *values, size_t count)
+{
+    if (!valid_parameters(ids, count))
+    {
+        return false;
+    }
+
+    PARAMETERS_LOCK();
+
+    uint32_t current = sequence;
+    ATOMIC_WRITE_INT(&sequence, current + 1U);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        parameter_t *parameter = &parameters[ids[i]];
+
+        ATOMIC_WRITE_U64(&parameter->value, convert_value(parameter->type, values[i]));
+        ATOMIC_WRITE_INT(&parameter->version, parameter->version + 1U);
+    }
+
+    ATOMIC_WRITE_INT(&sequence, current + 2U);
+
+    PARAMETERS_UNLOCK();
+
+    return true;
+}
+
+uint32_t foxdbg_parameters_version(int parameter)
+{
+    if (parameter < 0 || parameter >= ATOMIC_READ_INT(&parameter_count))
+    {
+        return 0;
+    }
+
+    return ATOMIC_READ_INT(&parameters[parameter].version);
+}
+
+uint32_t foxdbg_parameters_sequence(void)
+{
+    return ATOMIC_READ_INT(&sequence);
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+static int find_parameter(const char *name, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strncmp(parameters[i].name, name, FOXDBG_PARAMETER_NAME_LENGTH - 1) == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static bool valid_parameters(const int *ids, size_t count)
+{
+    int parameter_limit = ATOMIC_READ_INT(&parameter_count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (ids[i] < 0 || ids[i] >= parameter_limit)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static uint64_t convert_value(foxdbg_parameter_type_t type, double value)
+{
+    if (!isfinite(value) && type != FOXDBG_PARAMETER_TYPE_FLOAT)
+    {
+        value = 0.0;
+    }
+
+    switch (type)
+    {
+        case FOXDBG_PARAMETER_TYPE_INTEGER:
+        {
+            value = trunc(value);
+        } break;
+
+        case FOXDBG_PARAMETER_TYPE_BOOLEAN:
+        {
+            value = (value != 0.0) ? 1.0 : 0.0;
+        } break;
+
+        default:
+        {
+            /* stored as is */
+        } break;
+    }
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    return bits;
+}
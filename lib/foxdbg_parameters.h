@@ -0,0 +1,81 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_parameters.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Parameter Store
+**
+***************************************************************/
+
+#ifndef FOXDBG_PARAMETERS_H
+#define FOXDBG_PARAMETERS_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "foxdbg_channel.h"
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * add a parameter called name holding value. names are truncated to
+ * FOXDBG_PARAMETER_NAME_LENGTH - 1 characters. -1 if name is NULL, already
+ * used or the table already holds FOXDBG_MAX_PARAMETERS parameters.
+ */
+int foxdbg_parameters_add(const char *name, foxdbg_parameter_type_t type, double value);
+
+/* id of the parameter called name, -1 if there is none */
+int foxdbg_parameters_find(const char *name);
+
+/* parameters added so far, ids are 0..count-1 */
+int foxdbg_parameters_count(void);
+
+/* name and type of a parameter, never change once added */
+const char *foxdbg_parameters_name(int parameter);
+foxdbg_parameter_type_t foxdbg_parameters_type(int parameter);
+
+/* current value, a single atomic load. 0 for unknown ids */
+double foxdbg_parameters_read(int parameter);
+
+/* consistent snapshot of count parameters, never part of a group write. false for unknown ids */
+bool foxdbg_parameters_read_group(const int *parameters, double *values, size_t count);
+
+/*
+ * store count values at once, readers of the group see all of them or
+ * none. values are converted to the parameter's type. false, and nothing
+ * written, if any id is unknown.
+ */
+bool foxdbg_parameters_write_group(const int *parameters, const double *values, size_t count);
+
+/* bumped by every write, to notice changes without comparing values */
+uint32_t foxdbg_parameters_version(int parameter);
+uint32_t foxdbg_parameters_sequence(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_PARAMETERS_H */
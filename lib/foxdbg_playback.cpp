@@ -0,0 +1,293 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_playback.cpp
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server MCAP Playback
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_playback.h"
+#include "foxdbg_mcap.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+typedef struct
+{
+    uint16_t file_id;
+    std::string topic;
+    std::string schema_name;
+    std::string schema;
+    int channel_id;
+} playback_channel_t;
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static void restart(uint64_t now);
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+static foxdbg_mcap_reader_t *reader = NULL;
+
+static std::vector<playback_channel_t> playback_channels;
+static std::unordered_map<uint16_t, size_t> file_channels;     /* file channel id to index */
+
+static std::atomic_bool active(false);
+
+static double playback_speed = 1.0;
+static bool playback_loop = false;
+
+/* owned by the server thread once active */
+static bool clock_started = false;
+static uint64_t start_wall_time = 0;
+static uint64_t start_log_time = 0;
+
+static bool has_pending = false;
+static foxdbg_mcap_message_t pending;
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+bool foxdbg_playback_open(const char *path, double speed, bool loop)
+{
+    if (reader || speed <= 0.0)
+    {
+        return false;
+    }
+
+    reader = foxdbg_mcap_reader_open(path);
+
+    if (!reader)
+    {
+        return false;
+    }
+
+    playback_speed = speed;
+    playback_loop = loop;
+
+    for (size_t i = 0; i < foxdbg_mcap_reader_channel_count(reader); ++i)
+    {
+        const foxdbg_mcap_channel_t *channel = foxdbg_mcap_reader_channel(reader, i);
+
+        /* the websocket only advertises json */
+        if (strcmp(channel->message_encoding, "json") != 0)
+        {
+            fprintf(stderr, "FOXDBG: not playing %s, %s encoded\n", channel->topic, channel->message_encoding);
+            continue;
+        }
+
+        playback_channel_t playback_channel;
+        playback_channel.file_id = channel->id;
+        playback_channel.topic = channel->topic;
+        playback_channel.schema_name = channel->schema_name;
+        playback_channel.channel_id = -1;
+
+        if (strcmp(channel->schema_encoding, "jsonschema") == 0 && channel->schema)
+        {
+            playback_channel.schema.assign((const char *)channel->schema, channel->schema_size);
+        }
+
+        file_channels[channel->id] = playback_channels.size();
+        playback_channels.push_back(playback_channel);
+    }
+
+    printf("FOXDBG: Playing %s, %zu channels at %.2fx%s\n",
+        path, playback_channels.size(), speed, loop ? ", looping" : "");
+
+    return true;
+}
+
+void foxdbg_playback_close(void)
+{
+    active.store(false);
+
+    if (reader)
+    {
+        foxdbg_mcap_reader_close(reader);
+        reader = NULL;
+    }
+
+    playback_channels.clear();
+    file_channels.clear();
+
+    clock_started = false;
+    has_pending = false;
+}
+
+bool foxdbg_playback_active(void)
+{
+    return active.load();
+}
+
+size_t foxdbg_playback_channel_count(void)
+{
+    return playback_channels.size();
+}
+
+const char *foxdbg_playback_channel_topic(size_t index)
+{
+    return index < playback_channels.size() ? playback_channels[index].topic.c_str() : NULL;
+}
+
+void foxdbg_playback_bind(size_t index, int channel_id)
+{
+    if (index < playback_channels.size())
+    {
+        playback_channels[index].channel_id = channel_id;
+    }
+}
+
+void foxdbg_playback_start(void)
+{
+    if (reader)
+    {
+        active.store(true);
+    }
+}
+
+const char *foxdbg_playback_schema_name(int channel_id)
+{
+    for (const playback_channel_t &channel : playback_channels)
+    {
+        if (channel.channel_id == channel_id)
+        {
+            return channel.schema_name.c_str();
+        }
+    }
+
+    return "";
+}
+
+const char *foxdbg_playback_schema(int channel_id)
+{
+    for (const playback_channel_t &channel : playback_channels)
+    {
+        if (channel.channel_id == channel_id)
+        {
+            return channel.schema.c_str();
+        }
+    }
+
+    return "";
+}
+
+uint64_t foxdbg_playback_time(uint64_t now)
+{
+    if (!clock_started)
+    {
+        return reader ? foxdbg_mcap_reader_start_time(reader) : 0;
+    }
+
+    return start_log_time + (uint64_t)((double)(now - start_wall_time) * playback_speed);
+}
+
+bool foxdbg_playback_next(uint64_t now, foxdbg_playback_message_t *message)
+{
+    if (!active.load())
+    {
+        return false;
+    }
+
+    if (!clock_started)
+    {
+        restart(now);
+        clock_started = true;
+    }
+
+    while (true)
+    {
+        if (!has_pending)
+        {
+            if (!foxdbg_mcap_reader_next(reader, &pending))
+            {
+                if (!playback_loop)
+                {
+                    return false;
+                }
+
+                restart(now);
+
+                if (!foxdbg_mcap_reader_next(reader, &pending))
+                {
+                    return false; /* nothing to play */
+                }
+            }
+
+            has_pending = true;
+        }
+
+        uint64_t playback_time = foxdbg_playback_time(now);
+
+        if (pending.log_time > playback_time)
+        {
+            return false;
+        }
+
+        /* a client that cannot keep up skips ahead instead of falling further behind */
+        double lag_ms = (double)(playback_time - pending.log_time) / playback_speed / 1e6;
+
+        if (lag_ms > FOXDBG_PLAYBACK_MAX_LAG_MS)
+        {
+            foxdbg_mcap_reader_seek(reader, playback_time);
+            has_pending = false;
+            continue;
+        }
+
+        has_pending = false;
+
+        auto channel = file_channels.find(pending.channel_id);
+
+        if (channel == file_channels.end() || playback_channels[channel->second].channel_id < 0)
+        {
+            continue; /* not played */
+        }
+
+        message->channel_id = playback_channels[channel->second].channel_id;
+        message->log_time = pending.log_time;
+        message->data = pending.data;
+        message->size = pending.size;
+
+        return true;
+    }
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+/* back to the first message, due at now */
+static void restart(uint64_t now)
+{
+    start_wall_time = now;
+    start_log_time = foxdbg_mcap_reader_start_time(reader);
+
+    foxdbg_mcap_reader_seek(reader, start_log_time);
+    has_pending = false;
+}
@@ -0,0 +1,82 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_playback.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server MCAP Playback
+**
+***************************************************************/
+
+#ifndef FOXDBG_PLAYBACK_H
+#define FOXDBG_PLAYBACK_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/* messages this far behind the playback clock are skipped by seeking ahead */
+#define FOXDBG_PLAYBACK_MAX_LAG_MS (1000U)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+typedef struct
+{
+    int channel_id;             /* foxdbg channel bound to the file's channel */
+    uint64_t log_time;
+    const uint8_t *data;
+    size_t size;
+} foxdbg_playback_message_t;
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* map path for playback at speed times real time, false if it cannot be read */
+bool foxdbg_playback_open(const char *path, double speed, bool loop);
+
+void foxdbg_playback_close(void);
+
+/* true once every channel is bound */
+bool foxdbg_playback_active(void);
+
+/* json channels of the file, each to be bound to a foxdbg channel */
+size_t foxdbg_playback_channel_count(void);
+const char *foxdbg_playback_channel_topic(size_t index);
+void foxdbg_playback_bind(size_t index, int channel_id);
+
+/* start serving, the clock starts with the first foxdbg_playback_next */
+void foxdbg_playback_start(void);
+
+/* schema advertised for a bound foxdbg channel */
+const char *foxdbg_playback_schema_name(int channel_id);
+const char *foxdbg_playback_schema(int channel_id);
+
+/* playback clock at now (ns since epoch), in the file's log time */
+uint64_t foxdbg_playback_time(uint64_t now);
+
+/* next message due at now, false if none is due yet. called from the server thread */
+bool foxdbg_playback_next(uint64_t now, foxdbg_playback_message_t *message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_PLAYBACK_H */
@@ -0,0 +1,663 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_pointcloud.c
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Point Cloud Helpers
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_pointcloud.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define FOXDBG_POINTCLOUD_SSE2 (1U)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define FOXDBG_POINTCLOUD_NEON (1U)
+#endif
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+#define VOXEL_INDEX_LIMIT   ((float)(1U << (FOXDBG_VOXEL_INDEX_BITS - 1U)))
+#define VOXEL_INDEX_MASK    ((1ULL << FOXDBG_VOXEL_INDEX_BITS) - 1ULL)
+
+/* packed keys use 63 bits, so these never collide with a real voxel */
+#define EMPTY_SLOT  (UINT64_MAX)          /* memset 0xFF pattern */
+#define INVALID_KEY (UINT64_MAX - 1ULL)
+
+#define VOXEL_HASH_PRIME (0x9E3779B185EBCA87ULL)
+
+/* used when the cloud has no extent to derive a voxel size from */
+#define FALLBACK_VOXEL_SIZE (0.01f)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static bool reserve(void **buffer, size_t *capacity, size_t required, size_t element_size);
+
+static void compute_keys(const foxdbg_vector4_t *points, size_t count, float inv_size, uint64_t *keys);
+static uint64_t pack_key(int32_t x, int32_t y, int32_t z);
+
+static float initial_voxel_size(const foxdbg_vector4_t *points, size_t count, size_t point_budget);
+
+static void compute_bounds(const foxdbg_vector4_t *points, size_t count, foxdbg_vector4_t *min, foxdbg_vector4_t *max);
+static void pack_point(uint8_t *dst, float x, float y, float z, int32_t intensity);
+static float quantize_scalar(float value, float offset);
+
+#if defined(FOXDBG_POINTCLOUD_SSE2)
+static __m128 quantize_sse2(__m128 value, __m128 offset, __m128 grid, __m128 inv_grid);
+#elif defined(FOXDBG_POINTCLOUD_NEON)
+static float32x4_t quantize_neon(float32x4_t value, float32x4_t offset);
+#endif
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+/* grow-only scratch, only ever used from the server thread */
+static uint64_t *point_keys = NULL;
+static size_t point_keys_capacity = 0;
+
+static uint64_t *table_keys = NULL;
+static size_t table_keys_capacity = 0;
+static uint32_t *table_voxels = NULL;
+static size_t table_voxels_capacity = 0;
+
+static foxdbg_vector4_t *voxel_sums = NULL;
+static size_t voxel_sums_capacity = 0;
+static uint32_t *voxel_counts = NULL;
+static size_t voxel_counts_capacity = 0;
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+void foxdbg_pointcloud_shutdown(void)
+{
+    free(point_keys);
+    free(table_keys);
+    free(table_voxels);
+    free(voxel_sums);
+    free(voxel_counts);
+
+    point_keys = NULL;
+    table_keys = NULL;
+    table_voxels = NULL;
+    voxel_sums = NULL;
+    voxel_counts = NULL;
+
+    point_keys_capacity = 0;
+    table_keys_capacity = 0;
+    table_voxels_capacity = 0;
+    voxel_sums_capacity = 0;
+    voxel_counts_capacity = 0;
+}
+
+bool foxdbg_pointcloud_is_vector4(const foxdbg_pointcloud_info_t *info)
+{
+    if (!info)
+    {
+        return true;
+    }
+
+    if (info->point_stride != sizeof(foxdbg_vector4_t) || info->field_count < 3)
+    {
+        return false;
+    }
+
+    /* x, y, z and an optional fourth float in declaration order */
+    for (uint32_t i = 0; i < info->field_count && i < 4; i++)
+    {
+        if (info->fields[i].offset != i * sizeof(float) || info->fields[i].type != FOXDBG_FIELD_TYPE_FLOAT32)
+        {
+            return false;
+        }
+    }
+
+    return info->field_count <= 4;
+}
+
+size_t foxdbg_pointcloud_voxel_filter(foxdbg_vector4_t *points, size_t count, float voxel_size)
+{
+    if (count == 0 || !(voxel_size > 0.0f))
+    {
+        return count;
+    }
+
+    /* power of two with at most 50% load */
+    unsigned table_bits = 4;
+    while (((size_t)1 << table_bits) < count * 2)
+    {
+        table_bits++;
+    }
+
+    const size_t table_size = (size_t)1 << table_bits;
+    const size_t table_mask = table_size - 1;
+
+    if (!reserve((void **)&point_keys, &point_keys_capacity, count, sizeof(uint64_t)) ||
+        !reserve((void **)&table_keys, &table_keys_capacity, table_size, sizeof(uint64_t)) ||
+        !reserve((void **)&table_voxels, &table_voxels_capacity, table_size, sizeof(uint32_t)) ||
+        !reserve((void **)&voxel_sums, &voxel_sums_capacity, count, sizeof(foxdbg_vector4_t)) ||
+        !reserve((void **)&voxel_counts, &voxel_counts_capacity, count, sizeof(uint32_t)))
+    {
+        return count; /* out of memory, send unfiltered */
+    }
+
+    compute_keys(points, count, 1.0f / voxel_size, point_keys);
+
+    memset(table_keys, 0xFF, table_size * sizeof(uint64_t));
+
+    size_t voxel_count = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t key = point_keys[i];
+
+        if (key == INVALID_KEY)
+        {
+            continue;
+        }
+
+        size_t slot = (size_t)((key * VOXEL_HASH_PRIME) >> (64U - table_bits));
+
+        while (table_keys[slot] != EMPTY_SLOT && table_keys[slot] != key)
+        {
+            slot = (slot + 1) & table_mask;
+        }
+
+        if (table_keys[slot] == EMPTY_SLOT)
+        {
+            table_keys[slot] = key;
+            table_voxels[slot] = (uint32_t)voxel_count;
+
+            voxel_sums[voxel_count] = points[i];
+            voxel_counts[voxel_count] = 1;
+            voxel_count++;
+        }
+        else
+        {
+            foxdbg_vector4_t *sum = &voxel_sums[table_voxels[slot]];
+            sum->x += points[i].x;
+            sum->y += points[i].y;
+            sum->z += points[i].z;
+            sum->w += points[i].w;
+            voxel_counts[table_voxels[slot]]++;
+        }
+    }
+
+    /* every input point has been consumed, safe to overwrite in place */
+    for (size_t v = 0; v < voxel_count; v++)
+    {
+        float scale = 1.0f / (float)voxel_counts[v];
+
+        points[v].x = voxel_sums[v].x * scale;
+        points[v].y = voxel_sums[v].y * scale;
+        points[v].z = voxel_sums[v].z * scale;
+        points[v].w = voxel_sums[v].w * scale;
+    }
+
+    return voxel_count;
+}
+
+size_t foxdbg_pointcloud_downsample(foxdbg_vector4_t *points, size_t count, float voxel_size, size_t point_budget)
+{
+    float size = voxel_size > 0.0f ? voxel_size : 0.0f;
+
+    if (size > 0.0f)
+    {
+        count = foxdbg_pointcloud_voxel_filter(points, count, size);
+    }
+
+    /* later rounds filter the previous centroids, coarser but still bounded */
+    for (size_t round = 0; point_budget > 0 && count > point_budget && round < FOXDBG_VOXEL_BUDGET_ROUNDS; round++)
+    {
+        if (size > 0.0f)
+        {
+            float growth = sqrtf((float)count / (float)point_budget);
+            size *= growth > 1.25f ? growth : 1.25f;
+        }
+        else
+        {
+            size = initial_voxel_size(points, count, point_budget);
+        }
+
+        count = foxdbg_pointcloud_voxel_filter(points, count, size);
+    }
+
+    if (point_budget > 0 && count > point_budget)
+    {
+        /* uniform stride, source index never trails the destination */
+        for (size_t i = 0; i < point_budget; i++)
+        {
+            points[i] = points[(i * count) / point_budget];
+        }
+
+        count = point_budget;
+    }
+
+    return count;
+}
+
+size_t foxdbg_pointcloud_quantize(foxdbg_vector4_t *points, size_t count, foxdbg_vector3_t *offset)
+{
+    offset->x = 0.0f;
+    offset->y = 0.0f;
+    offset->z = 0.0f;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    foxdbg_vector4_t min, max;
+    compute_bounds(points, count, &min, &max);
+
+    /* centre on the grid so the offsets keep as many zero mantissa bits as possible */
+    offset->x = roundf((min.x + max.x) * 0.5f * FOXDBG_QUANTIZE_GRID) / FOXDBG_QUANTIZE_GRID;
+    offset->y = roundf((min.y + max.y) * 0.5f * FOXDBG_QUANTIZE_GRID) / FOXDBG_QUANTIZE_GRID;
+    offset->z = roundf((min.z + max.z) * 0.5f * FOXDBG_QUANTIZE_GRID) / FOXDBG_QUANTIZE_GRID;
+
+    float intensity_min = min.w;
+    float intensity_scale = max.w > min.w ? 255.0f / (max.w - min.w) : 0.0f;
+
+    uint8_t *dst = (uint8_t *)points;
+    size_t i = 0;
+
+    /* packed output trails the input, every block is loaded before it is overwritten */
+#if defined(FOXDBG_POINTCLOUD_SSE2)
+
+    const __m128 grid = _mm_set1_ps(FOXDBG_QUANTIZE_GRID);
+    const __m128 inv_grid = _mm_set1_ps(1.0f / FOXDBG_QUANTIZE_GRID);
+    const __m128 ox = _mm_set1_ps(offset->x);
+    const __m128 oy = _mm_set1_ps(offset->y);
+    const __m128 oz = _mm_set1_ps(offset->z);
+    const __m128 imin = _mm_set1_ps(intensity_min);
+    const __m128 iscale = _mm_set1_ps(intensity_scale);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(&points[i + 0].x);
+        __m128 y = _mm_loadu_ps(&points[i + 1].x);
+        __m128 z = _mm_loadu_ps(&points[i + 2].x);
+        __m128 w = _mm_loadu_ps(&points[i + 3].x);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        x = quantize_sse2(x, ox, grid, inv_grid);
+        y = quantize_sse2(y, oy, grid, inv_grid);
+        z = quantize_sse2(z, oz, grid, inv_grid);
+        __m128i intensity = _mm_cvtps_epi32(_mm_mul_ps(_mm_sub_ps(w, imin), iscale));
+
+        float xs[4], ys[4], zs[4];
+        int32_t is[4];
+        _mm_storeu_ps(xs, x);
+        _mm_storeu_ps(ys, y);
+        _mm_storeu_ps(zs, z);
+        _mm_storeu_si128((__m128i *)is, intensity);
+
+        for (int k = 0; k < 4; k++)
+        {
+            pack_point(dst + (i + k) * FOXDBG_QUANTIZED_POINT_STRIDE, xs[k], ys[k], zs[k], is[k]);
+        }
+    }
+
+#elif defined(FOXDBG_POINTCLOUD_NEON)
+
+    const float32x4_t ox = vdupq_n_f32(offset->x);
+    const float32x4_t oy = vdupq_n_f32(offset->y);
+    const float32x4_t oz = vdupq_n_f32(offset->z);
+    const float32x4_t imin = vdupq_n_f32(intensity_min);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4x4_t p = vld4q_f32(&points[i].x);
+
+        float32x4_t x = quantize_neon(p.val[0], ox);
+        float32x4_t y = quantize_neon(p.val[1], oy);
+        float32x4_t z = quantize_neon(p.val[2], oz);
+        int32x4_t intensity = vcvtnq_s32_f32(vmulq_n_f32(vsubq_f32(p.val[3], imin), intensity_scale));
+
+        float xs[4], ys[4], zs[4];
+        int32_t is[4];
+        vst1q_f32(xs, x);
+        vst1q_f32(ys, y);
+        vst1q_f32(zs, z);
+        vst1q_s32(is, intensity);
+
+        for (int k = 0; k < 4; k++)
+        {
+            pack_point(dst + (i + k) * FOXDBG_QUANTIZED_POINT_STRIDE, xs[k], ys[k], zs[k], is[k]);
+        }
+    }
+
+#endif
+
+    for (; i < count; i++)
+    {
+        foxdbg_vector4_t p = points[i];
+
+        float intensity = (p.w - intensity_min) * intensity_scale;
+
+        pack_point(
+            dst + i * FOXDBG_QUANTIZED_POINT_STRIDE,
+            quantize_scalar(p.x, offset->x),
+            quantize_scalar(p.y, offset->y),
+            quantize_scalar(p.z, offset->z),
+            intensity == intensity ? (int32_t)nearbyintf(intensity) : 0
+        );
+    }
+
+    return count * FOXDBG_QUANTIZED_POINT_STRIDE;
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+static bool reserve(void **buffer, size_t *capacity, size_t required, size_t element_size)
+{
+    if (*buffer && *capacity >= required)
+    {
+        return true;
+    }
+
+    void *grown = realloc(*buffer, required * element_size);
+    if (!grown)
+    {
+        return false;
+    }
+
+    *buffer = grown;
+    *capacity = required;
+
+    return true;
+}
+
+static void compute_keys(const foxdbg_vector4_t *points, size_t count, float inv_size, uint64_t *keys)
+{
+    size_t i = 0;
+
+#if defined(FOXDBG_POINTCLOUD_SSE2)
+
+    const __m128 scale = _mm_set1_ps(inv_size);
+    const __m128 limit = _mm_set1_ps(VOXEL_INDEX_LIMIT);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(&points[i + 0].x);
+        __m128 y = _mm_loadu_ps(&points[i + 1].x);
+        __m128 z = _mm_loadu_ps(&points[i + 2].x);
+        __m128 w = _mm_loadu_ps(&points[i + 3].x);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        x = _mm_mul_ps(x, scale);
+        y = _mm_mul_ps(y, scale);
+        z = _mm_mul_ps(z, scale);
+
+        /* false for NaN, infinity and anything outside the packable range */
+        __m128 valid = _mm_and_ps(
+            _mm_and_ps(_mm_cmplt_ps(_mm_andnot_ps(sign, x), limit), _mm_cmplt_ps(_mm_andnot_ps(sign, y), limit)),
+            _mm_cmplt_ps(_mm_andnot_ps(sign, z), limit)
+        );
+
+        /* floor: truncate, then step down where truncation rounded up */
+        __m128i ix = _mm_cvttps_epi32(x);
+        __m128i iy = _mm_cvttps_epi32(y);
+        __m128i iz = _mm_cvttps_epi32(z);
+        ix = _mm_add_epi32(ix, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(ix), x)));
+        iy = _mm_add_epi32(iy, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(iy), y)));
+        iz = _mm_add_epi32(iz, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(iz), z)));
+
+        int32_t xs[4], ys[4], zs[4];
+        _mm_storeu_si128((__m128i *)xs, ix);
+        _mm_storeu_si128((__m128i *)ys, iy);
+        _mm_storeu_si128((__m128i *)zs, iz);
+
+        int mask = _mm_movemask_ps(valid);
+
+        for (int k = 0; k < 4; k++)
+        {
+            keys[i + k] = (mask & (1 << k)) ? pack_key(xs[k], ys[k], zs[k]) : INVALID_KEY;
+        }
+    }
+
+#elif defined(FOXDBG_POINTCLOUD_NEON)
+
+    const float32x4_t limit = vdupq_n_f32(VOXEL_INDEX_LIMIT);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4x4_t p = vld4q_f32(&points[i].x); /* de-interleaves x, y, z, w */
+
+        float32x4_t x = vmulq_n_f32(p.val[0], inv_size);
+        float32x4_t y = vmulq_n_f32(p.val[1], inv_size);
+        float32x4_t z = vmulq_n_f32(p.val[2], inv_size);
+
+        uint32x4_t valid = vandq_u32(
+            vandq_u32(vcaltq_f32(x, limit), vcaltq_f32(y, limit)),
+            vcaltq_f32(z, limit)
+        );
+
+        int32x4_t ix = vcvtq_s32_f32(x);
+        int32x4_t iy = vcvtq_s32_f32(y);
+        int32x4_t iz = vcvtq_s32_f32(z);
+        ix = vaddq_s32(ix, vreinterpretq_s32_u32(vcgtq_f32(vcvtq_f32_s32(ix), x)));
+        iy = vaddq_s32(iy, vreinterpretq_s32_u32(vcgtq_f32(vcvtq_f32_s32(iy), y)));
+        iz = vaddq_s32(iz, vreinterpretq_s32_u32(vcgtq_f32(vcvtq_f32_s32(iz), z)));
+
+        int32_t xs[4], ys[4], zs[4];
+        uint32_t vs[4];
+        vst1q_s32(xs, ix);
+        vst1q_s32(ys, iy);
+        vst1q_s32(zs, iz);
+        vst1q_u32(vs, valid);
+
+        for (int k = 0; k < 4; k++)
+        {
+            keys[i + k] = vs[k] ? pack_key(xs[k], ys[k], zs[k]) : INVALID_KEY;
+        }
+    }
+
+#endif
+
+    for (; i < count; i++)
+    {
+        float x = points[i].x * inv_size;
+        float y = points[i].y * inv_size;
+        float z = points[i].z * inv_size;
+
+        if (!(fabsf(x) < VOXEL_INDEX_LIMIT && fabsf(y) < VOXEL_INDEX_LIMIT && fabsf(z) < VOXEL_INDEX_LIMIT))
+        {
+            keys[i] = INVALID_KEY;
+            continue;
+        }
+
+        keys[i] = pack_key((int32_t)floorf(x), (int32_t)floorf(y), (int32_t)floorf(z));
+    }
+}
+
+static uint64_t pack_key(int32_t x, int32_t y, int32_t z)
+{
+    return ((uint64_t)(uint32_t)x & VOXEL_INDEX_MASK) |
+           (((uint64_t)(uint32_t)y & VOXEL_INDEX_MASK) << FOXDBG_VOXEL_INDEX_BITS) |
+           (((uint64_t)(uint32_t)z & VOXEL_INDEX_MASK) << (FOXDBG_VOXEL_INDEX_BITS * 2U));
+}
+
+static float initial_voxel_size(const foxdbg_vector4_t *points, size_t count, size_t point_budget)
+{
+    float min[3] = { INFINITY, INFINITY, INFINITY };
+    float max[3] = { -INFINITY, -INFINITY, -INFINITY };
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const float p[3] = { points[i].x, points[i].y, points[i].z };
+
+        for (int a = 0; a < 3; a++)
+        {
+            /* comparisons are false for NaN, so those points are ignored */
+            if (p[a] < min[a]) min[a] = p[a];
+            if (p[a] > max[a]) max[a] = p[a];
+        }
+    }
+
+    /* largest extent first */
+    float extent[3];
+    for (int a = 0; a < 3; a++)
+    {
+        extent[a] = max[a] > min[a] ? max[a] - min[a] : 0.0f;
+    }
+
+    for (int a = 0; a < 2; a++)
+    {
+        for (int b = a + 1; b < 3; b++)
+        {
+            if (extent[b] > extent[a])
+            {
+                float tmp = extent[a];
+                extent[a] = extent[b];
+                extent[b] = tmp;
+            }
+        }
+    }
+
+    /* clouds are mostly surfaces, so spread the budget over the two largest extents */
+    float size = extent[1] > 0.0f
+        ? sqrtf((extent[0] * extent[1]) / (float)point_budget)
+        : extent[0] / (float)point_budget;
+
+    return (isfinite(size) && size > 0.0f) ? size : FALLBACK_VOXEL_SIZE;
+}
+
+static void compute_bounds(const foxdbg_vector4_t *points, size_t count, foxdbg_vector4_t *min, foxdbg_vector4_t *max)
+{
+    /* axes without a finite range report [0, 0] */
+    float lo[4] = { INFINITY, INFINITY, INFINITY, INFINITY };
+    float hi[4] = { -INFINITY, -INFINITY, -INFINITY, -INFINITY };
+    size_t i = 0;
+
+#if defined(FOXDBG_POINTCLOUD_SSE2)
+
+    /* minps/maxps return the second operand for NaN, so NaN lanes are skipped */
+    __m128 vlo = _mm_loadu_ps(lo);
+    __m128 vhi = _mm_loadu_ps(hi);
+
+    for (; i < count; i++)
+    {
+        __m128 p = _mm_loadu_ps(&points[i].x);
+        vlo = _mm_min_ps(p, vlo);
+        vhi = _mm_max_ps(p, vhi);
+    }
+
+    _mm_storeu_ps(lo, vlo);
+    _mm_storeu_ps(hi, vhi);
+
+#elif defined(FOXDBG_POINTCLOUD_NEON)
+
+    /* vminnm/vmaxnm ignore NaN operands */
+    float32x4_t vlo = vld1q_f32(lo);
+    float32x4_t vhi = vld1q_f32(hi);
+
+    for (; i < count; i++)
+    {
+        float32x4_t p = vld1q_f32(&points[i].x);
+        vlo = vminnmq_f32(vlo, p);
+        vhi = vmaxnmq_f32(vhi, p);
+    }
+
+    vst1q_f32(lo, vlo);
+    vst1q_f32(hi, vhi);
+
+#endif
+
+    for (; i < count; i++)
+    {
+        const float p[4] = { points[i].x, points[i].y, points[i].z, points[i].w };
+
+        for (int a = 0; a < 4; a++)
+        {
+            if (p[a] < lo[a]) lo[a] = p[a];
+            if (p[a] > hi[a]) hi[a] = p[a];
+        }
+    }
+
+    /* empty, all-NaN or infinite axes */
+    for (int a = 0; a < 4; a++)
+    {
+        if (!isfinite(lo[a]) || !isfinite(hi[a]))
+        {
+            lo[a] = 0.0f;
+            hi[a] = 0.0f;
+        }
+    }
+
+    min->x = lo[0]; min->y = lo[1]; min->z = lo[2]; min->w = lo[3];
+    max->x = hi[0]; max->y = hi[1]; max->z = hi[2]; max->w = hi[3];
+}
+
+static void pack_point(uint8_t *dst, float x, float y, float z, int32_t intensity)
+{
+    uint8_t value = (uint8_t)(intensity < 0 ? 0 : (intensity > 255 ? 255 : intensity));
+
+    memcpy(dst + 0, &x, sizeof(float));
+    memcpy(dst + 4, &y, sizeof(float));
+    memcpy(dst + 8, &z, sizeof(float));
+    dst[12] = value;
+}
+
+static float quantize_scalar(float value, float offset)
+{
+    /* NaN passes through so invalid returns stay invisible */
+    if (value != value)
+    {
+        return value;
+    }
+
+    /* via int32 like the SIMD paths, so -0.0 comes out as 0.0 */
+    return (float)(int32_t)nearbyintf((value - offset) * FOXDBG_QUANTIZE_GRID) / FOXDBG_QUANTIZE_GRID;
+}
+
+#if defined(FOXDBG_POINTCLOUD_SSE2)
+
+static __m128 quantize_sse2(__m128 value, __m128 offset, __m128 grid, __m128 inv_grid)
+{
+    /* round to the nearest grid step and back to metres, keeping NaN lanes */
+    __m128 snapped = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(_mm_sub_ps(value, offset), grid))), inv_grid);
+    __m128 valid = _mm_cmpord_ps(value, value);
+
+    return _mm_or_ps(_mm_and_ps(valid, snapped), _mm_andnot_ps(valid, value));
+}
+
+#elif defined(FOXDBG_POINTCLOUD_NEON)
+
+static float32x4_t quantize_neon(float32x4_t value, float32x4_t offset)
+{
+    float32x4_t snapped = vmulq_n_f32(
+        vcvtq_f32_s32(vcvtnq_s32_f32(vmulq_n_f32(vsubq_f32(value, offset), FOXDBG_QUANTIZE_GRID))),
+        1.0f / FOXDBG_QUANTIZE_GRID
+    );
+
+    return vbslq_f32(vceqq_f32(value, value), snapped, value);
+}
+
+#endif
@@ -0,0 +1,81 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_pointcloud.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Point Cloud Helpers
+**
+***************************************************************/
+
+#ifndef FOXDBG_POINTCLOUD_H
+#define FOXDBG_POINTCLOUD_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "foxdbg_channel.h"
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/* voxel indices are packed into 21 bits per axis */
+#define FOXDBG_VOXEL_INDEX_BITS (21U)
+
+/* attempts at growing the voxel size before falling back to striding */
+#define FOXDBG_VOXEL_BUDGET_ROUNDS (4U)
+
+/* quantized points: float32 x, y, z on a 1/1024 m grid plus uint8 intensity */
+#define FOXDBG_QUANTIZED_POINT_STRIDE (13U)
+#define FOXDBG_QUANTIZE_GRID (1024.0f)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void foxdbg_pointcloud_shutdown(void);
+
+/* true if info is NULL or describes foxdbg_vector4_t points */
+bool foxdbg_pointcloud_is_vector4(const foxdbg_pointcloud_info_t *info);
+
+/*
+ * replace every occupied voxel with the centroid (and mean intensity) of
+ * its points, in place. non-finite points are dropped. returns the new count.
+ */
+size_t foxdbg_pointcloud_voxel_filter(foxdbg_vector4_t *points, size_t count, float voxel_size);
+
+/*
+ * voxel filter with voxel_size (if > 0), then keep growing the voxel until
+ * at most point_budget points remain (if > 0). returns the new count.
+ */
+size_t foxdbg_pointcloud_downsample(foxdbg_vector4_t *points, size_t count, float voxel_size, size_t point_budget);
+
+/*
+ * re-centre the cloud on *offset and snap it to the quantization grid,
+ * packing FOXDBG_QUANTIZED_POINT_STRIDE byte points in place. intensity is
+ * scaled from the message's own range to 0..255. returns the packed size.
+ */
+size_t foxdbg_pointcloud_quantize(foxdbg_vector4_t *points, size_t count, foxdbg_vector3_t *offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_POINTCLOUD_H */
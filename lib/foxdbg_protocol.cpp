@@ -19,18 +19,38 @@
 #include "foxdbg.h"
 #include "foxdbg_protocol.h"
 #include "foxdbg_atomic.h"
+#include "foxdbg_image.h"
+#include "foxdbg_encoder.h"
+#include "foxdbg_pointcloud.h"
+#include "foxdbg_hash.h"
+#include "foxdbg_math.h"
+#include "foxdbg_frames.h"
+#include "foxdbg_time.h"
+#include "foxdbg_recorder.h"
+#include "foxdbg_flight.h"
+#include "foxdbg_playback.h"
+#include "foxdbg_parameters.h"
+#include "foxdbg_json.h"
+#include "foxdbg_events.h"
+#include "foxdbg_thread.h"
 
 #include <sstream>
-#include <chrono>
 #include <vector>
+#include <string>
+#include <unordered_map>
 
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 
-#include <turbojpeg.h>
 #include <libwebsockets.h>
 
+#if defined(__linux__)
+    #include <sys/ioctl.h>
+    #include <linux/sockios.h>
+#endif
+
 #include <json/json.hpp>
 
 #define _USE_MATH_DEFINES
@@ -42,6 +62,17 @@ using json = nlohmann::json;
 ** MARK: CONSTANTS & MACROS
 ***************************************************************/
 
+#define PATH_THICKNESS (0.05f)
+
+/* largest client message reassembled from lws fragments, larger ones are dropped */
+#define RX_MESSAGE_SIZE (256U * 1024U)
+
+/* longest topic or parameter name read from a client message */
+#define RX_NAME_LENGTH (256U)
+
+/* how often the playback clock is sent to the client */
+#define PLAYBACK_TIME_INTERVAL_MS (50U)
+
 #ifdef _WIN32
 #include <windows.h>
 uint64_t current_timestamp_ms() {
@@ -66,14 +97,134 @@ uint64_t current_timestamp_ms() {
 ** MARK: TYPEDEFS
 ***************************************************************/
 
+typedef struct
+{
+    uint64_t hash;          /* of the primitive last sent */
+    uint64_t changed_time;
+    uint64_t lifetime;      /* ms, 0 never expires */
+    uint32_t seen_frame;
+} scene_entity_state_t;
+
+typedef struct
+{
+    std::unordered_map<uint32_t, scene_entity_state_t> entities;
+    int subscription_id;
+    uint32_t frame;
+} scene_state_t;
+
+/* a changed entity, its state is kept only once the message carrying it is sent */
+typedef struct
+{
+    uint32_t id;
+    scene_entity_state_t state;
+    std::string entity;
+} scene_update_t;
+
+typedef struct
+{
+    foxdbg_vector3_t position;
+    foxdbg_vector4_t rotation;
+} sent_transform_t;
+
+typedef struct
+{
+    std::unordered_map<int, sent_transform_t> sent;     /* by child frame */
+    int subscription_id;
+    uint64_t refresh_time;                              /* last time every transform was sent */
+} transform_state_t;
+
+typedef enum
+{
+    RX_OP_SUBSCRIBE,
+    RX_OP_UNSUBSCRIBE,
+    RX_OP_ADVERTISE,
+    RX_OP_UNADVERTISE,
+    RX_OP_GET_PARAMETERS,
+    RX_OP_SET_PARAMETERS,
+    RX_OP_SUBSCRIBE_PARAMETERS,
+    RX_OP_UNSUBSCRIBE_PARAMETERS,
+    RX_OP_UNKNOWN
+} rx_op_t;
+
+typedef struct
+{
+    const char *name;
+    rx_op_t op;
+    const char *list;       /* key of the list the op carries */
+} rx_op_info_t;
+
+/* fields read from the elements of a list, see rx_field_names */
+typedef enum
+{
+    RX_FIELD_ID,
+    RX_FIELD_CHANNEL_ID,
+    RX_FIELD_TOPIC,
+    RX_FIELD_ENCODING,
+    RX_FIELD_NAME,
+    RX_FIELD_VALUE,         /* also the element itself for lists of ids or names */
+    RX_FIELD_COUNT
+} rx_field_t;
+
+typedef struct
+{
+    bool at_op;
+    const rx_op_info_t *op;
+} rx_op_scan_t;
+
+/* client message being read, events point into its text */
+typedef struct
+{
+    const rx_op_info_t *op;
+    bool in_list;
+    bool at_request_id;
+    bool has_request_id;
+    foxdbg_json_event_t request_id;
+
+    rx_field_t field;       /* field of the current element being read, RX_FIELD_COUNT for none */
+    uint32_t fields;        /* bit per field the current element has */
+    foxdbg_json_event_t element[RX_FIELD_COUNT];
+
+    /* parameters named by a get, or values of a set applied once the message is read */
+    bool names_given;
+    int parameter_ids[FOXDBG_MAX_PARAMETERS];
+    double parameter_values[FOXDBG_MAX_PARAMETERS];
+    size_t parameter_count;
+} rx_message_t;
+
+typedef struct
+{
+    bool at_value;
+    bool found;
+    foxdbg_json_event_t value;
+} rx_value_scan_t;
+
+/* counters of a channel when FOXDBG_STATS_TOPIC was last sent */
+typedef struct
+{
+    uint64_t write_count;
+    uint64_t send_count;
+    uint64_t send_bytes;
+    foxdbg_latency_t encode_time;
+    foxdbg_latency_t latency;
+} stats_snapshot_t;
+
 /***************************************************************
 ** MARK: STATIC FUNCTION DEFS
 ***************************************************************/
 
 static void send_json(json data);
-static void send_buffer(uint8_t *buffer, size_t buffer_size, size_t data_size, int subscription_id);
+static bool send_buffer(uint8_t *buffer, size_t buffer_size, size_t data_size, int subscription_id);
+static bool is_unchanged(foxdbg_channel_t *channel, int subscription_id, uint64_t current_time);
+static void reset_client_state(foxdbg_channel_t *channel);
+static bool is_recorded(foxdbg_channel_t *channel);
+static void send_channel(foxdbg_channel_t *channel, bool to_client, bool to_recorder, bool to_flight);
+static void delete_protocol_state(foxdbg_channel_t *channel, void *state);
+static const char *channel_schema_name(foxdbg_channel_type_t channel_type);
+static const std::string &channel_schema(foxdbg_channel_type_t channel_type);
 
 static void send_server_info(void);
+static void send_playback(void);
+static void send_time(uint64_t timestamp);
 static void send_advertise(void);
 
 static void send_image(foxdbg_channel_t *channel);
@@ -86,66 +237,190 @@ static void send_location(foxdbg_channel_t *channel);
 static void send_float(foxdbg_channel_t *channel);
 static void send_integer(foxdbg_channel_t *channel);
 static void send_bool(foxdbg_channel_t *channel);
+static void send_scene(foxdbg_channel_t *channel);
+static void send_spheres(foxdbg_channel_t *channel);
+static void send_arrows(foxdbg_channel_t *channel);
+static void send_triangles(foxdbg_channel_t *channel);
+static void send_text(foxdbg_channel_t *channel);
+static void send_poses(foxdbg_channel_t *channel);
+static void send_path(foxdbg_channel_t *channel);
+static void send_transforms(foxdbg_channel_t *channel);
+static void send_stats(foxdbg_channel_t *channel);
+
+static void begin_payload(foxdbg_channel_t *channel, void **data, size_t *data_size);
+static bool read_array(foxdbg_channel_t *channel, size_t element_size, size_t *count);
+static json channel_entity(foxdbg_channel_t *channel);
+static void send_entity(const json &entity, int subscription_id);
+
+static void receive_message(const char *data, size_t len);
+static void receive_json(const char *data, size_t len);
+static bool find_op(void *context, const foxdbg_json_event_t *event);
+static bool receive_event(void *context, const foxdbg_json_event_t *event);
+static void receive_element(rx_message_t *message);
+static bool rx_field_integer(const rx_message_t *message, rx_field_t field, int64_t min, int64_t max, int64_t *out);
+static bool rx_field_string(const rx_message_t *message, rx_field_t field, char *out, size_t out_size);
+static void reply_parameters(const rx_message_t *message, bool all);
+static void receive_data(const uint8_t *data, size_t len);
+static foxdbg_channel_t *find_rx_channel(const char *topic_name);
+static bool decode_rx_value(foxdbg_channel_t *channel, const char *text, size_t len, uint32_t *value);
+static bool find_value(void *context, const foxdbg_json_event_t *event);
+static bool decode_rx_scalar(foxdbg_channel_t *channel, const foxdbg_json_event_t *event, uint32_t *value);
+static void push_subscription(foxdbg_channel_t *channel, bool subscribed);
+
+static void send_parameter_updates(void);
+static json parameter_object(int parameter);
+
+static json cube_object(const foxdbg_cube_t *cube, const foxdbg_vector4_t *orientation);
+static json line_list_objects(const foxdbg_line_t *lines, size_t count);
+static json quaternion_object(const foxdbg_vector4_t *q);
+static json arrow_object(const foxdbg_pose_t *pose, const foxdbg_vector4_t *orientation);
+static json sphere_object(const foxdbg_sphere_t *sphere);
+static json arrow_array_object(const foxdbg_arrow_t *arrow, const foxdbg_vector4_t *orientation);
+static json triangle_list_object(const foxdbg_triangle_t *triangles, size_t count);
+static json text_object(const foxdbg_text_t *text);
+static json color_object(const foxdbg_color_t *color);
+static json timestamp_object(void);
+static void record_latency(foxdbg_channel_t *channel, uint64_t write_time, uint64_t now);
+static void record_duration(foxdbg_latency_t *latency, uint64_t duration_ns);
+static json duration_object(const foxdbg_latency_t *latency, const foxdbg_latency_t *last);
+static uint64_t bucket_percentile(const foxdbg_latency_t *latency, const foxdbg_latency_t *last, double p);
+static uint64_t socket_queued_bytes(void);
+static void drop_payload(foxdbg_channel_t *channel, const char *reason);
+static json frame_transform_object(const foxdbg_frame_transform_t *transform, const foxdbg_vector4_t *rotation);
+static bool transform_moved(foxdbg_channel_t *channel, const sent_transform_t *sent, const foxdbg_frame_transform_t *transform, const foxdbg_vector4_t *rotation);
+static json scene_entity(const foxdbg_scene_entity_t *scene_entity);
+
+static size_t scene_primitive_size(foxdbg_scene_primitive_t type);
+static bool flush_scene_update(std::string &message, int subscription_id);
 
 static size_t encode_image_byte_array(
     uint8_t* tx_buffer, 
     size_t tx_buffer_size, 
-    int width, int height, int components,
+    int width, int height, int components, const char *encoding,
     const uint8_t* compressedImage, size_t compressedSize
 );
 
+/* writes data as a JSON array of decimal bytes, returns 0 if it does not fit */
+static size_t encode_byte_array(uint8_t* buffer, size_t buffer_size, const uint8_t* data, size_t data_size);
+
 /***************************************************************
 ** MARK: STATIC VARIABLES
 ***************************************************************/
 
-static uint8_t raw_data_buffer[10*1024*1024];
-static uint8_t encode_buffer[10*1024*1024];
+alignas(16) static uint8_t raw_data_buffer[10*1024*1024];
 static uint8_t info_data_buffer[1024*1024];
 
 static uint8_t tx_buffer[1024*1024]; /* 1MB tx buffer */
 
-static size_t encode_buffer_size = sizeof(encode_buffer);
 static size_t tx_buffer_size = sizeof(tx_buffer);
 
+/* payload being sent, stamps the messages built from it */
+static foxdbg_channel_t *payload_channel = NULL;
+static uint64_t payload_timestamp = 0;
+static uint64_t payload_write_time = 0;
+
+/* where the messages built from the current payload go */
+static bool payload_to_client = false;
+static bool payload_to_recorder = false;
+static bool payload_to_flight = false;
+
+/* bytes built for the current payload, whether or not they went anywhere */
+static size_t payload_encoded_size = 0;
+
+/* hash of the current payload, and whether every message built from it so far was sent */
+static uint64_t payload_hash = 0;
+static bool payload_delivered = false;
+
+/* FOXDBG_STATS_TOPIC reports the change in each channel's counters since it was last sent */
+static std::unordered_map<int, stats_snapshot_t> stats_last;
+static uint64_t stats_last_time = 0;
+
+/* marker orientations, converted in one batch before serialization */
+static std::vector<foxdbg_vector4_t> orientation_buffer;
+
 static struct lws_context *context = NULL;
 static struct lws *client = NULL;
 
 static foxdbg_channel_t **channels = NULL;
 static size_t *channel_count = 0;
 
-static tjhandle jpeg_handle = NULL;
+static foxdbg_channel_t **rx_channels = NULL;
+static size_t *rx_channel_count = 0;
+
+/* rx channel each client channel publishes to, from the client's advertise */
+static std::unordered_map<uint32_t, foxdbg_channel_t *> client_channels;
+
+/* lws splits large messages, they are put back together here */
+static char rx_message[RX_MESSAGE_SIZE];
+static size_t rx_message_size = 0;
+static bool rx_message_overflow = false;
 
-static int jpegSubsamp = TJSAMP_420; /* Default to 4:2:0 subsampling */
-static int jpegQuality = 25; /* Default quality factor */
+static const rx_op_info_t rx_ops[] = {
+    { "subscribe", RX_OP_SUBSCRIBE, "subscriptions" },
+    { "unsubscribe", RX_OP_UNSUBSCRIBE, "subscriptionIds" },
+    { "advertise", RX_OP_ADVERTISE, "channels" },
+    { "unadvertise", RX_OP_UNADVERTISE, "channelIds" },
+    { "getParameters", RX_OP_GET_PARAMETERS, "parameterNames" },
+    { "setParameters", RX_OP_SET_PARAMETERS, "parameters" },
+    { "subscribeParameterUpdates", RX_OP_SUBSCRIBE_PARAMETERS, "parameterNames" },
+    { "unsubscribeParameterUpdates", RX_OP_UNSUBSCRIBE_PARAMETERS, "parameterNames" },
+    { "", RX_OP_UNKNOWN, "" } /* last, any other op */
+};
+
+static const char *const rx_field_names[RX_FIELD_COUNT] = { "id", "channelId", "topic", "encoding", "name", "value" };
+
+/* parameters the client watches, and the version it last saw */
+static bool parameter_subscribed[FOXDBG_MAX_PARAMETERS];
+static uint32_t parameter_sent_version[FOXDBG_MAX_PARAMETERS];
+static uint32_t parameter_sequence_sent = 0;
+
+static uint64_t last_time_sent = 0;
 
 /***************************************************************
 ** MARK: PUBLIC FUNCTIONS
 ***************************************************************/
 
-void foxdbg_protocol_init(lws_context *context_ptr, foxdbg_channel_t **channels_ptr, size_t *channel_count_ptr)
+void foxdbg_protocol_init(lws_context *context_ptr, foxdbg_channel_t **channels_ptr, size_t *channel_count_ptr, foxdbg_channel_t **rx_channels_ptr, size_t *rx_channel_count_ptr)
 {
     context = context_ptr;
     channels = channels_ptr;
     channel_count = channel_count_ptr;
+    rx_channels = rx_channels_ptr;
+    rx_channel_count = rx_channel_count_ptr;
 
-    jpeg_handle = tjInitCompress();
-    if (jpeg_handle == NULL)
-    {
-        fprintf(stderr, "Failed to initialize JPEG compressor: %s\n", tjGetErrorStr());
-    }
+    stats_last.clear();
+    stats_last_time = foxdbg_time_ns();
+
+    foxdbg_encoder_init(foxdbg_thread_worker_count());
 }
 
 void foxdbg_protocol_shutdown(void)
 {
-    if (jpeg_handle)
+    foxdbg_encoder_shutdown();
+    foxdbg_pointcloud_shutdown();
+
+    foxdbg_channel_t *current = channels ? *channels : NULL;
+
+    while (current)
     {
-        tjDestroy(jpeg_handle);
-        jpeg_handle = NULL;
+        delete_protocol_state(current, current->protocol_state);
+        delete_protocol_state(current, current->recorder_state);
+
+        current->protocol_state = NULL;
+        current->recorder_state = NULL;
+        current = current->next;
     }
 
+    std::vector<foxdbg_vector4_t>().swap(orientation_buffer);
+
+    std::unordered_map<uint32_t, foxdbg_channel_t *>().swap(client_channels);
+    std::unordered_map<int, stats_snapshot_t>().swap(stats_last);
+
     context = NULL;
     channels = NULL;
     channel_count = 0;
+    rx_channels = NULL;
+    rx_channel_count = 0;
 
     client = NULL;
 }
@@ -167,123 +442,74 @@ void foxdbg_protocol_disconnect(lws *client_ptr)
 {
     client = NULL;
 
+    client_channels.clear();
+
+    rx_message_size = 0;
+    rx_message_overflow = false;
+
+    memset(parameter_subscribed, 0, sizeof(parameter_subscribed));
+
     foxdbg_channel_t *current = *channels;
 
     while (current)
     {
-        ATOMIC_WRITE_INT(&current->subscription_id, -1);
+        if (ATOMIC_READ_INT(&current->subscription_id) >= 0)
+        {
+            ATOMIC_WRITE_INT(&current->subscription_id, -1);
+            push_subscription(current, false);
+        }
+
+        /* the next client reuses subscription ids from 0 */
+        reset_client_state(current);
+
         current = current->next;
     }
 }
 
-void foxdbg_protocol_receive(char* data, size_t len)
+size_t foxdbg_protocol_encode(foxdbg_channel_t *channel)
 {
-    if (len < 1)
-    {
-        fprintf(stderr, "Invalid data length\n");
-        return;
-    }
+    payload_encoded_size = 0;
 
-    if (data[0] == 0x01)
-    {
-        /* handle binary data */
-        //receive_data(data, len);
-        return;
-    }
+    send_channel(channel, false, false, false);
 
-    json json_object = json::parse((char *)data, (char *)data + len);
+    return payload_encoded_size;
+}
 
-    if (!json_object.is_object() || !json_object.contains("op"))
+void foxdbg_protocol_receive(const char *data, size_t len, bool final)
+{
+    /* whole messages are read where lws left them, only split ones are copied */
+    if (final && rx_message_size == 0 && !rx_message_overflow)
     {
-        fprintf(stderr, "Invalid JSON message\n");
+        receive_message(data, len);
         return;
     }
-    else if (json_object["op"] == "subscribe")
-    {
-        if (json_object.contains("subscriptions"))
-        {
-            for (auto& subscription : json_object["subscriptions"])
-            {
-                try {
-
-                    int subscription_id = subscription["id"].get<int>();
-                    int channel_id = subscription["channelId"].get<int>();
-
-                    foxdbg_channel_t *channel = *channels;
 
-                    while (channel)
-                    {
-                        if (channel->channel_id == channel_id)
-                        {
-                            ATOMIC_WRITE_INT(&channel->subscription_id, subscription_id);
-
-                            #if FOXDBG_DEBUG_PROTOCOL
-                                printf("FOXDBG: Client subscribed to %s\n", channel->topic_name);
-                            #endif
-
-                            return;
-                        }
-                        channel = channel->next;
-                    }
-                }
-                catch (...)
-                {
-                    /* JSON error */
-                }
-            }
-        }
+    if (!rx_message_overflow && len <= sizeof(rx_message) - rx_message_size)
+    {
+        memcpy(rx_message + rx_message_size, data, len);
+        rx_message_size += len;
     }
-    else if (json_object["op"] == "unsubscribe")
+    else
     {
-        if (json_object.contains("subscriptionIds"))
-        {
-            for (auto& subscription_id : json_object["subscriptionIds"])
-            {
-                try {
-
-                    int subscription_id_int = subscription_id.get<int>();
-                    
-                    foxdbg_channel_t *channel = *channels;
-
-                    while (channel)
-                    {
-                        if (ATOMIC_READ_INT(&channel->subscription_id) == subscription_id_int)
-                        {
-                            ATOMIC_WRITE_INT(&channel->subscription_id, -1);
-
-                            #if FOXDBG_DEBUG_PROTOCOL
-                                printf("FOXDBG: Client unsubscribed from %s\n", channel->topic_name);
-                            #endif
-                            return;
-                        }
-                        channel = channel->next;
-                    }
-
-                }
-                catch (...)
-                {
-                    /* JSON error */
-                }
-
-                
-            }
-        }
+        rx_message_overflow = true;
     }
-    else if (json_object["op"] == "advertise")
+
+    if (!final)
     {
-        //printf("FOXDBG: RX advertise\n");
-        //receive_advertise(json_object);
+        return;
     }
-    else if (json_object["op"] == "unadvertise")
+
+    if (rx_message_overflow)
     {
-        //printf("FOXDBG: RX unadvertise\n");
-        //receive_unadvertise(json_object);
+        fprintf(stderr, "FOXDBG: Client message too large\n");
     }
     else
     {
-        //printf("FOXDBG: RX %s\n", json_object.dump().c_str());
+        receive_message(rx_message, rx_message_size);
     }
 
+    rx_message_size = 0;
+    rx_message_overflow = false;
 }
 
 void foxdbg_protocol_transmit_subscriptions(void)
@@ -298,64 +524,60 @@ void foxdbg_protocol_transmit_subscriptions(void)
         uint64_t last_time = current->last_tx_time;
         uint64_t elapsed = current_time - last_time;
 
-        if (subscription_id >= 0 && elapsed > current->target_tx_time)
-        {
-            switch (current->channel_type)
-            {
-                case FOXDBG_CHANNEL_TYPE_IMAGE:
-                {
-                    send_image(current);
-                } break;
+        bool to_client = client && subscription_id >= 0 && elapsed > current->target_tx_time &&
+            !is_unchanged(current, subscription_id, current_time);
 
-                case FOXDBG_CHANNEL_TYPE_POINTCLOUD:
-                {
-                    send_pointcloud(current);
-                } break;
+        /* every new payload is recorded, whatever the client's rate */
+        bool to_record = !is_recorded(current);
+        bool to_recorder = to_record && foxdbg_recorder_active();
+        bool to_flight = to_record && ATOMIC_READ_U64(&current->flight_quota) > 0;
 
-                case FOXDBG_CHANNEL_TYPE_CUBES:
-                {
-                    send_cubes(current);
-                } break;
+        bool stateful = current->channel_type == FOXDBG_CHANNEL_TYPE_SCENE ||
+            current->channel_type == FOXDBG_CHANNEL_TYPE_TRANSFORMS;
 
-                case FOXDBG_CHANNEL_TYPE_LINES:
-                {
-                    send_lines(current);
-                } break;
+        if (!stateful)
+        {
+            if (to_client || to_recorder || to_flight)
+            {
+                uint64_t encode_start = foxdbg_time_ns();
 
-                case FOXDBG_CHANNEL_TYPE_TRANSFORM:
-                {
-                    send_transform(current);
-                } break;
+                send_channel(current, to_client, to_recorder, to_flight);
 
-                case FOXDBG_CHANNEL_TYPE_LOCATION:
+                if (to_client)
                 {
-                    send_location(current);
-                } break;
+                    record_duration(&current->encode_time, foxdbg_time_ns() - encode_start);
+                }
+            }
+        }
+        else
+        {
+            /* each destination holds different entities, so gets its own messages */
+            if (to_client)
+            {
+                uint64_t encode_start = foxdbg_time_ns();
 
-                case FOXDBG_CHANNEL_TYPE_POSE:
-                {
-                    send_pose(current);
-                } break;
+                send_channel(current, true, false, false);
 
-                case FOXDBG_CHANNEL_TYPE_FLOAT:
-                {
-                    send_float(current);
-                } break;
+                record_duration(&current->encode_time, foxdbg_time_ns() - encode_start);
+            }
 
-                case FOXDBG_CHANNEL_TYPE_INTEGER:
-                {
-                    send_integer(current);
-                } break;
+            if (to_recorder)
+            {
+                std::swap(current->protocol_state, current->recorder_state);
+                send_channel(current, false, true, false);
+                std::swap(current->protocol_state, current->recorder_state);
+            }
 
-                case FOXDBG_CHANNEL_TYPE_BOOLEAN:
-                {
-                    send_bool(current);
-                } break;
+            if (to_flight)
+            {
+                /* the ring drops old messages, every kept one has to stand alone */
+                void *state = current->protocol_state;
+                current->protocol_state = NULL;
 
-                default:
-                {
+                send_channel(current, false, false, true);
 
-                } break;
+                delete_protocol_state(current, current->protocol_state);
+                current->protocol_state = state;
             }
         }
 
@@ -366,6 +588,32 @@ void foxdbg_protocol_transmit_subscriptions(void)
 
         current = current->next;
     }
+
+    send_playback();
+    send_parameter_updates();
+}
+
+bool foxdbg_protocol_has_client(void)
+{
+    return client != NULL;
+}
+
+bool foxdbg_protocol_is_recording(void)
+{
+    if (foxdbg_recorder_active())
+    {
+        return true;
+    }
+
+    for (foxdbg_channel_t *current = *channels; current; current = current->next)
+    {
+        if (ATOMIC_READ_U64(&current->flight_quota) > 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 /***************************************************************
@@ -400,18 +648,61 @@ static void send_json(json data)
 
 }
 
-static void send_buffer(uint8_t *buffer, size_t buffer_size, size_t data_size, int subscription_id)
+/* false if the message did not reach every destination */
+static bool send_buffer(uint8_t *buffer, size_t buffer_size, size_t data_size, int subscription_id)
 {
-    if (!client)
+    if (payload_to_client && !client)
     {
         fprintf(stderr, "Client not connected\n");
-        return;
+        payload_delivered = false;
+        return false;
     }
 
     if ((data_size + LWS_PRE) > sizeof(tx_buffer))
     {
-        fprintf(stderr, "Buffer message too large\n");
-        return;
+        drop_payload(payload_channel, "Buffer message too large");
+        return false;
+    }
+
+    payload_encoded_size += data_size;
+
+    uint64_t now = foxdbg_time_ns();
+    uint64_t nsec = payload_timestamp ? payload_timestamp : now;
+
+    /* recordings hold the json after the websocket header */
+    if (payload_to_recorder && payload_channel)
+    {
+        foxdbg_recorder_write(
+            payload_channel->channel_id,
+            payload_channel->topic_name,
+            channel_schema_name(payload_channel->channel_type),
+            channel_schema(payload_channel->channel_type).c_str(),
+            nsec,
+            payload_write_time ? payload_write_time : now,
+            buffer + 13,
+            data_size - 13
+        );
+    }
+
+    if (payload_to_flight && payload_channel)
+    {
+        foxdbg_flight_write(
+            payload_channel->channel_id,
+            payload_channel->topic_name,
+            channel_schema_name(payload_channel->channel_type),
+            channel_schema(payload_channel->channel_type).c_str(),
+            nsec,
+            payload_write_time ? payload_write_time : now,
+            buffer + 13,
+            data_size - 13,
+            (size_t)ATOMIC_READ_U64(&payload_channel->flight_quota),
+            ATOMIC_READ_U64(&payload_channel->flight_retention)
+        );
+    }
+
+    if (!payload_to_client)
+    {
+        return true;
     }
 
     /* Header setup */
@@ -422,9 +713,10 @@ static void send_buffer(uint8_t *buffer, size_t buffer_size, size_t data_size, i
     buf[3] =  static_cast<uint8_t>((subscription_id >> 16) & 0xFF);
     buf[4] =  static_cast<uint8_t>((subscription_id >> 24) & 0xFF);
 
-    uint64_t nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::system_clock::now().time_since_epoch()
-    ).count();
+    if (payload_channel && payload_write_time)
+    {
+        record_latency(payload_channel, payload_write_time, now);
+    }
 
     for (int i = 0; i < 8; ++i)
     {
@@ -432,179 +724,1726 @@ static void send_buffer(uint8_t *buffer, size_t buffer_size, size_t data_size, i
     }
 
 
-    lws_write(client, buffer, data_size, LWS_WRITE_BINARY);
+    if (lws_write(client, buffer, data_size, LWS_WRITE_BINARY) < 0)
+    {
+        drop_payload(payload_channel, "Client write failed");
+        return false;
+    }
+
+    if (payload_channel)
+    {
+        payload_channel->send_count++;
+        payload_channel->send_bytes += data_size;
+
+        /* only a payload the client got in full counts for skip_unchanged */
+        if (payload_delivered)
+        {
+            payload_channel->last_sent_hash = payload_hash;
+            payload_channel->last_sent_subscription_id = subscription_id;
+            payload_channel->last_sent_time = current_timestamp_ms();
+        }
+    }
 
+    return true;
 }
 
+static bool is_unchanged(foxdbg_channel_t *channel, int subscription_id, uint64_t current_time)
+{
+    if (!channel->skip_unchanged)
+    {
+        return false;
+    }
+
+    void *data = NULL;
+    size_t data_size = 0;
 
-static void send_server_info(void)
+    foxdbg_buffer_begin_read(channel->data_buffer, &data, &data_size);
+    uint64_t hash = foxdbg_buffer_get_hash(channel->data_buffer);
+    foxdbg_buffer_end_read(channel->data_buffer);
+
+    bool keepalive_due = channel->keepalive_time > 0 &&
+        (current_time - channel->last_sent_time) >= channel->keepalive_time;
+
+    /* a new subscription always gets the current payload, send_buffer records what was delivered */
+    return hash != 0 && hash == channel->last_sent_hash &&
+        subscription_id == channel->last_sent_subscription_id && !keepalive_due;
+}
+
+/* forget what the client was sent, so whoever subscribes next gets everything again */
+static void reset_client_state(foxdbg_channel_t *channel)
 {
-    json server_info = {
-        {"op", "serverInfo"},
-        {"name", "TBReAI FOXDBG"},
-        {"capabilities", {"clientPublish"}},
-        {"supportedEncodings", {"json", "binary"}},
-        {"metadata", json::object()}
-    };
+    channel->last_sent_subscription_id = -1;
 
-    send_json(server_info);
+    /* scene entities and transforms already sent */
+    delete_protocol_state(channel, channel->protocol_state);
+    channel->protocol_state = NULL;
 }
 
-static void send_advertise(void)
+/* encode the channel's current payload for the given destinations */
+static void send_channel(foxdbg_channel_t *channel, bool to_client, bool to_recorder, bool to_flight)
 {
-    json channels_info = {
-        {"op", "advertise"},
-        {"channels", json::array()}
-    };
+    payload_to_client = to_client;
+    payload_to_recorder = to_recorder;
+    payload_to_flight = to_flight;
 
-    foxdbg_channel_t *current = *channels;
+    payload_hash = 0;
+    payload_delivered = true;
 
-    while (current)
+    switch (channel->channel_type)
     {
+        case FOXDBG_CHANNEL_TYPE_IMAGE:
+        {
+            send_image(channel);
+        } break;
 
-        std::string channel_schema;
+        case FOXDBG_CHANNEL_TYPE_POINTCLOUD:
+        {
+            send_pointcloud(channel);
+        } break;
 
-        switch (current->channel_type)
+        case FOXDBG_CHANNEL_TYPE_CUBES:
         {
-            case FOXDBG_CHANNEL_TYPE_IMAGE:
-            {
-                channel_schema = "foxglove.CompressedImage";
-            } break;
+            send_cubes(channel);
+        } break;
 
-            case FOXDBG_CHANNEL_TYPE_POINTCLOUD:
-            {
-                channel_schema = "foxglove.PointCloud";
-            } break;
+        case FOXDBG_CHANNEL_TYPE_LINES:
+        {
+            send_lines(channel);
+        } break;
 
-            case FOXDBG_CHANNEL_TYPE_CUBES:
-            {
-                channel_schema = "foxglove.SceneUpdate";
-            } break;
+        case FOXDBG_CHANNEL_TYPE_TRANSFORM:
+        {
+            send_transform(channel);
+        } break;
 
-            case FOXDBG_CHANNEL_TYPE_LINES:
-            {
-                channel_schema = "foxglove.SceneUpdate";
-            } break;
+        case FOXDBG_CHANNEL_TYPE_LOCATION:
+        {
+            send_location(channel);
+        } break;
 
-            case FOXDBG_CHANNEL_TYPE_POSE:
-            {
-                channel_schema = "foxglove.SceneUpdate";
-            } break;
+        case FOXDBG_CHANNEL_TYPE_POSE:
+        {
+            send_pose(channel);
+        } break;
 
-            case FOXDBG_CHANNEL_TYPE_TRANSFORM:
-            {
-                channel_schema = "foxglove.FrameTransform";
-            } break;
+        case FOXDBG_CHANNEL_TYPE_FLOAT:
+        {
+            send_float(channel);
+        } break;
 
-            case FOXDBG_CHANNEL_TYPE_LOCATION:
-            {
-                channel_schema = "foxglove.LocationFix";
-            } break;
+        case FOXDBG_CHANNEL_TYPE_INTEGER:
+        {
+            send_integer(channel);
+        } break;
 
-            case FOXDBG_CHANNEL_TYPE_FLOAT:
-            {
-                channel_schema = "foxdbg.Float";
-            } break;
+        case FOXDBG_CHANNEL_TYPE_BOOLEAN:
+        {
+            send_bool(channel);
+        } break;
 
-            case FOXDBG_CHANNEL_TYPE_INTEGER:
-            {
-                channel_schema = "foxdbg.Integer";
-            } break;
+        case FOXDBG_CHANNEL_TYPE_SCENE:
+        {
+            send_scene(channel);
+        } break;
 
-            case FOXDBG_CHANNEL_TYPE_BOOLEAN:
-            {
-                channel_schema = "foxdbg.Boolean";
-            } break;
+        case FOXDBG_CHANNEL_TYPE_SPHERES:
+        {
+            send_spheres(channel);
+        } break;
 
-            default:
-            {
-                channel_schema = "foxglove.Unknown";
-            } break;
-        }
+        case FOXDBG_CHANNEL_TYPE_ARROWS:
+        {
+            send_arrows(channel);
+        } break;
 
-        json channel_info = {
-            {"id", current->channel_id},
-            {"topic", current->topic_name},
-            {"encoding", "json"},
-            {"schemaName", channel_schema},
-            {"schema", json::string_t()}
-        };
+        case FOXDBG_CHANNEL_TYPE_TRIANGLES:
+        {
+            send_triangles(channel);
+        } break;
 
-        switch (current->channel_type)
+        case FOXDBG_CHANNEL_TYPE_TEXT:
         {
-            case FOXDBG_CHANNEL_TYPE_FLOAT:
-            {
-                json custom_schema = {
-                    {"title", "foxdbg.Float"},
-                    {"description", "float value"},
-                    {"type", "object"},
-                    {"properties", {
-                        {"value", {
-                            {"type", "number"},
-                            {"description", "float value"}
-                        }}
-                    }}
-                };
-    
-                channel_info["schema"] = custom_schema.dump();
-            } break;
+            send_text(channel);
+        } break;
 
-            case FOXDBG_CHANNEL_TYPE_INTEGER:
-            {
-                json custom_schema = {
-                    {"title", "foxdbg.Integer"},
-                    {"description", "float value"},
-                    {"type", "object"},
-                    {"properties", {
-                        {"value", {
-                            {"type", "integer"},
-                            {"description", "int value"}
-                        }}
-                    }}
-                };
-    
-                channel_info["schema"] = custom_schema.dump();
-            } break;
+        case FOXDBG_CHANNEL_TYPE_POSES:
+        {
+            send_poses(channel);
+        } break;
 
-            case FOXDBG_CHANNEL_TYPE_BOOLEAN:
-            {
-                json custom_schema = {
-                    {"title", "foxdbg.Boolean"},
-                    {"description", "bool value"},
-                    {"type", "object"},
-                    {"properties", {
-                        {"value", {
-                            {"type", "boolean"},
-                            {"description", "bool value"}
-                        }}
-                    }}
-                };
-    
-                channel_info["schema"] = custom_schema.dump();
-            } break;
+        case FOXDBG_CHANNEL_TYPE_PATH:
+        {
+            send_path(channel);
+        } break;
 
+        case FOXDBG_CHANNEL_TYPE_TRANSFORMS:
+        {
+            send_transforms(channel);
+        } break;
 
-            default:
-            {
-                /* no custom schema */
-            } break;
-        }
+        case FOXDBG_CHANNEL_TYPE_STATS:
+        {
+            send_stats(channel);
+        } break;
 
-        channels_info["channels"].push_back(channel_info);
+        default:
+        {
 
-        current = current->next;
+        } break;
     }
 
-    send_json(channels_info);
+    /* the buffer may have swapped since is_recorded looked */
+    if ((payload_to_recorder || payload_to_flight) && payload_write_time)
+    {
+        channel->recorded_write_time = payload_write_time;
+    }
+
+    payload_channel = NULL;
+    payload_timestamp = 0;
+    payload_write_time = 0;
+    payload_to_client = false;
+    payload_to_recorder = false;
+    payload_to_flight = false;
 }
 
-static void send_image(foxdbg_channel_t *channel)
+/* true if neither the recorder nor the flight ring wants the channel, or they have its current payload */
+static bool is_recorded(foxdbg_channel_t *channel)
 {
-    void *data;
-    size_t data_size;
-    foxdbg_buffer_begin_read(channel->data_buffer, &data, &data_size);
+    if (!foxdbg_recorder_active() && ATOMIC_READ_U64(&channel->flight_quota) == 0)
+    {
+        return true;
+    }
+
+    void *data = NULL;
+    size_t data_size = 0;
+
+    foxdbg_buffer_begin_read(channel->data_buffer, &data, &data_size);
+    uint64_t write_time = foxdbg_buffer_get_write_time(channel->data_buffer);
+    foxdbg_buffer_end_read(channel->data_buffer);
+
+    if (write_time == 0 || write_time == channel->recorded_write_time)
+    {
+        return true;
+    }
+
+    /* payloads that do not encode to anything are not retried */
+    channel->recorded_write_time = write_time;
+
+    return false;
+}
+
+static void delete_protocol_state(foxdbg_channel_t *channel, void *state)
+{
+    if (channel->channel_type == FOXDBG_CHANNEL_TYPE_SCENE)
+    {
+        delete (scene_state_t *)state;
+    }
+    else if (channel->channel_type == FOXDBG_CHANNEL_TYPE_TRANSFORMS)
+    {
+        delete (transform_state_t *)state;
+    }
+}
+
+static void send_server_info(void)
+{
+    json capabilities = json::array({"clientPublish", "parameters", "parametersSubscribe"});
+
+    /* playback drives the client's clock with time messages */
+    if (foxdbg_playback_active())
+    {
+        capabilities.push_back("time");
+    }
+
+    json server_info = {
+        {"op", "serverInfo"},
+        {"name", "TBReAI FOXDBG"},
+        {"capabilities", capabilities},
+        {"supportedEncodings", {"json"}},
+        {"metadata", json::object()}
+    };
+
+    send_json(server_info);
+}
+
+/* send every playback message that is due to its subscriber, then the playback clock */
+static void send_playback(void)
+{
+    if (!client || !foxdbg_playback_active())
+    {
+        return;
+    }
+
+    uint64_t now = foxdbg_time_ns();
+
+    /* the clock starts with the first subscription, so the client sees the file from its start */
+    bool subscribed = false;
+
+    for (foxdbg_channel_t *current = *channels; current && !subscribed; current = current->next)
+    {
+        subscribed = current->channel_type == FOXDBG_CHANNEL_TYPE_PLAYBACK &&
+            ATOMIC_READ_INT(&current->subscription_id) >= 0;
+    }
+
+    foxdbg_playback_message_t message;
+
+    while (subscribed && foxdbg_playback_next(now, &message))
+    {
+        foxdbg_channel_t *channel = *channels;
+
+        while (channel && channel->channel_id != message.channel_id)
+        {
+            channel = channel->next;
+        }
+
+        int subscription_id = channel ? ATOMIC_READ_INT(&channel->subscription_id) : -1;
+
+        if (subscription_id < 0)
+        {
+            continue;
+        }
+
+        if (message.size + LWS_PRE + 13 > tx_buffer_size)
+        {
+            drop_payload(channel, "Buffer message too large");
+            continue;
+        }
+
+        memcpy(tx_buffer + LWS_PRE + 13, message.data, message.size);
+
+        payload_channel = channel;
+        payload_timestamp = message.log_time;
+        payload_to_client = true;
+
+        send_buffer(
+            (uint8_t*)tx_buffer + LWS_PRE, 
+            tx_buffer_size, 
+            message.size + 13,
+            subscription_id
+        );
+
+        payload_channel = NULL;
+        payload_timestamp = 0;
+        payload_to_client = false;
+    }
+
+    if (now - last_time_sent >= PLAYBACK_TIME_INTERVAL_MS * 1000000ULL)
+    {
+        send_time(foxdbg_playback_time(now));
+        last_time_sent = now;
+    }
+}
+
+static void send_time(uint64_t timestamp)
+{
+    uint8_t buffer[LWS_PRE + 9];
+
+    buffer[LWS_PRE] = 0x02;
+
+    for (int i = 0; i < 8; ++i)
+    {
+        buffer[LWS_PRE + 1 + i] = static_cast<uint8_t>((timestamp >> (8 * i)) & 0xFF);
+    }
+
+    lws_write(client, buffer + LWS_PRE, 9, LWS_WRITE_BINARY);
+}
+
+static void send_advertise(void)
+{
+    json channels_info = {
+        {"op", "advertise"},
+        {"channels", json::array()}
+    };
+
+    foxdbg_channel_t *current = *channels;
+
+    while (current)
+    {
+        bool playback = current->channel_type == FOXDBG_CHANNEL_TYPE_PLAYBACK;
+
+        json channel_info = {
+            {"id", current->channel_id},
+            {"topic", current->topic_name},
+            {"encoding", "json"},
+            {"schemaName", playback ? foxdbg_playback_schema_name(current->channel_id) : channel_schema_name(current->channel_type)},
+            {"schema", playback ? foxdbg_playback_schema(current->channel_id) : channel_schema(current->channel_type)}
+        };
+
+        channels_info["channels"].push_back(channel_info);
+
+        current = current->next;
+    }
+
+    send_json(channels_info);
+}
+
+static void receive_message(const char *data, size_t len)
+{
+    if (len < 1)
+    {
+        fprintf(stderr, "Invalid data length\n");
+        return;
+    }
+
+    if (data[0] == 0x01)
+    {
+        receive_data((const uint8_t *)data, len);
+        return;
+    }
+
+    receive_json(data, len);
+}
+
+/* one text message from the client, dispatched on its op in two passes over the text */
+static void receive_json(const char *data, size_t len)
+{
+    rx_op_scan_t scan = { false, NULL };
+
+    foxdbg_json_parse(data, len, find_op, &scan);
+
+    if (!scan.op)
+    {
+        fprintf(stderr, "FOXDBG: Invalid JSON message\n");
+        return;
+    }
+
+    if (scan.op->op == RX_OP_UNKNOWN)
+    {
+        return; /* an op this server does not handle */
+    }
+
+    rx_message_t message;
+    message.op = scan.op;
+    message.in_list = false;
+    message.at_request_id = false;
+    message.has_request_id = false;
+    message.field = RX_FIELD_COUNT;
+    message.fields = 0;
+    message.names_given = false;
+    message.parameter_count = 0;
+
+    bool valid = foxdbg_json_parse(data, len, receive_event, &message) == FOXDBG_JSON_OK;
+
+    if (!valid)
+    {
+        /* elements before the error are applied, except parameters which are set as a whole */
+        fprintf(stderr, "FOXDBG: Invalid JSON message\n");
+    }
+
+    switch (message.op->op)
+    {
+        case RX_OP_GET_PARAMETERS:
+        {
+            reply_parameters(&message, !message.names_given);
+        } break;
+
+        case RX_OP_SET_PARAMETERS:
+        {
+            if (valid && message.parameter_count > 0)
+            {
+                foxdbg_parameters_write_group(message.parameter_ids, message.parameter_values, message.parameter_count);
+
+                for (size_t i = 0; i < message.parameter_count; i++)
+                {
+                    foxdbg_event_t event = {};
+                    event.type = FOXDBG_EVENT_PARAMETER;
+                    event.id = message.parameter_ids[i];
+                    event.parameter_value = foxdbg_parameters_read(event.id);
+
+                    foxdbg_events_push(&event);
+                }
+            }
+
+            if (valid && message.has_request_id)
+            {
+                reply_parameters(&message, false);
+            }
+        } break;
+
+        default:
+        {
+            /* applied element by element */
+        } break;
+    }
+}
+
+/* stops at the value of the top level "op" */
+static bool find_op(void *context, const foxdbg_json_event_t *event)
+{
+    rx_op_scan_t *scan = (rx_op_scan_t *)context;
+
+    if (event->depth != 1)
+    {
+        return true;
+    }
+
+    if (event->type == FOXDBG_JSON_KEY)
+    {
+        scan->at_op = foxdbg_json_equals(event, "op");
+        return true;
+    }
+
+    if (!scan->at_op)
+    {
+        return true;
+    }
+
+    if (event->type == FOXDBG_JSON_STRING)
+    {
+        size_t count = sizeof(rx_ops) / sizeof(rx_ops[0]);
+
+        scan->op = &rx_ops[count - 1]; /* unknown */
+
+        for (size_t i = 0; i < count - 1; i++)
+        {
+            if (foxdbg_json_equals(event, rx_ops[i].name))
+            {
+                scan->op = &rx_ops[i];
+                break;
+            }
+        }
+    }
+
+    return false;
+}
+
+/*
+ * every op carries one list (subscriptions, channelIds, parameterNames...),
+ * each element is applied as soon as it has been read
+ */
+static bool receive_event(void *context, const foxdbg_json_event_t *event)
+{
+    rx_message_t *message = (rx_message_t *)context;
+
+    switch (event->depth)
+    {
+        case 1:
+        {
+            if (event->type == FOXDBG_JSON_KEY)
+            {
+                message->in_list = foxdbg_json_equals(event, message->op->list);
+                message->at_request_id = foxdbg_json_equals(event, "id");
+            }
+            else if (message->at_request_id)
+            {
+                message->request_id = *event;
+                message->has_request_id = event->type == FOXDBG_JSON_STRING || event->type == FOXDBG_JSON_NUMBER;
+                message->at_request_id = false;
+            }
+        } break;
+
+        case 2:
+        {
+            if (!message->in_list)
+            {
+                break;
+            }
+
+            if (event->type == FOXDBG_JSON_OBJECT_BEGIN)
+            {
+                message->fields = 0;
+                message->field = RX_FIELD_COUNT;
+            }
+            else if (event->type == FOXDBG_JSON_OBJECT_END)
+            {
+                receive_element(message);
+            }
+            else if (event->type != FOXDBG_JSON_ARRAY_BEGIN && event->type != FOXDBG_JSON_ARRAY_END)
+            {
+                /* lists of ids or names */
+                message->element[RX_FIELD_VALUE] = *event;
+                message->fields = 1U << RX_FIELD_VALUE;
+                receive_element(message);
+            }
+        } break;
+
+        case 3:
+        {
+            if (!message->in_list)
+            {
+                break;
+            }
+
+            if (event->type == FOXDBG_JSON_KEY)
+            {
+                message->field = RX_FIELD_COUNT;
+
+                for (size_t i = 0; i < RX_FIELD_COUNT; i++)
+                {
+                    if (foxdbg_json_equals(event, rx_field_names[i]))
+                    {
+                        message->field = (rx_field_t)i;
+                        break;
+                    }
+                }
+            }
+            else if (message->field != RX_FIELD_COUNT)
+            {
+                /* a nested value is kept as its begin event, and rejected by type */
+                message->element[message->field] = *event;
+                message->fields |= 1U << message->field;
+                message->field = RX_FIELD_COUNT;
+            }
+        } break;
+
+        default:
+        {
+            /* deeper than any field that is read */
+        } break;
+    }
+
+    return true;
+}
+
+static void receive_element(rx_message_t *message)
+{
+    const foxdbg_json_event_t *element = message->element;
+    char name[RX_NAME_LENGTH];
+    int64_t id;
+    int64_t channel_id;
+
+    switch (message->op->op)
+    {
+        case RX_OP_SUBSCRIBE:
+        {
+            if (!rx_field_integer(message, RX_FIELD_ID, 0, INT32_MAX, &id) ||
+                !rx_field_integer(message, RX_FIELD_CHANNEL_ID, 0, INT32_MAX, &channel_id))
+            {
+                break;
+            }
+
+            for (foxdbg_channel_t *channel = *channels; channel; channel = channel->next)
+            {
+                if (channel->channel_id == (int)channel_id)
+                {
+                    ATOMIC_WRITE_INT(&channel->subscription_id, (int)id);
+                    push_subscription(channel, true);
+
+                    #if FOXDBG_DEBUG_PROTOCOL
+                        printf("FOXDBG: Client subscribed to %s\n", channel->topic_name);
+                    #endif
+                    break;
+                }
+            }
+        } break;
+
+        case RX_OP_UNSUBSCRIBE:
+        {
+            if (!rx_field_integer(message, RX_FIELD_VALUE, 0, INT32_MAX, &id))
+            {
+                break;
+            }
+
+            for (foxdbg_channel_t *channel = *channels; channel; channel = channel->next)
+            {
+                if (ATOMIC_READ_INT(&channel->subscription_id) == (int)id)
+                {
+                    ATOMIC_WRITE_INT(&channel->subscription_id, -1);
+                    push_subscription(channel, false);
+                    reset_client_state(channel);
+
+                    #if FOXDBG_DEBUG_PROTOCOL
+                        printf("FOXDBG: Client unsubscribed from %s\n", channel->topic_name);
+                    #endif
+                    break;
+                }
+            }
+        } break;
+
+        case RX_OP_ADVERTISE:
+        {
+            /* map the client's channels to the rx channels with the same topic */
+            if (!rx_field_integer(message, RX_FIELD_ID, 0, UINT32_MAX, &id) ||
+                !rx_field_string(message, RX_FIELD_TOPIC, name, sizeof(name)))
+            {
+                break;
+            }
+
+            foxdbg_channel_t *rx_channel = find_rx_channel(name);
+
+            if (!rx_channel)
+            {
+                fprintf(stderr, "FOXDBG: Client advertised %s, no rx channel\n", name);
+                break;
+            }
+
+            if (!(message->fields & (1U << RX_FIELD_ENCODING)) || !foxdbg_json_equals(&element[RX_FIELD_ENCODING], "json"))
+            {
+                fprintf(stderr, "FOXDBG: Client advertised %s, only json is decoded\n", name);
+                break;
+            }
+
+            client_channels[(uint32_t)id] = rx_channel;
+
+            #if FOXDBG_DEBUG_PROTOCOL
+                printf("FOXDBG: Client publishing to %s\n", rx_channel->topic_name);
+            #endif
+        } break;
+
+        case RX_OP_UNADVERTISE:
+        {
+            if (rx_field_integer(message, RX_FIELD_VALUE, 0, UINT32_MAX, &id))
+            {
+                client_channels.erase((uint32_t)id);
+            }
+        } break;
+
+        case RX_OP_GET_PARAMETERS:
+        {
+            message->names_given = true;
+
+            int parameter = rx_field_string(message, RX_FIELD_VALUE, name, sizeof(name)) ? foxdbg_parameters_find(name) : -1;
+
+            if (parameter >= 0 && message->parameter_count < FOXDBG_MAX_PARAMETERS)
+            {
+                message->parameter_ids[message->parameter_count++] = parameter;
+            }
+        } break;
+
+        case RX_OP_SET_PARAMETERS:
+        {
+            int parameter = rx_field_string(message, RX_FIELD_NAME, name, sizeof(name)) ? foxdbg_parameters_find(name) : -1;
+
+            if (parameter < 0 || !(message->fields & (1U << RX_FIELD_VALUE)) || message->parameter_count == FOXDBG_MAX_PARAMETERS)
+            {
+                break; /* parameters cannot be created or deleted by the client */
+            }
+
+            const foxdbg_json_event_t *value = &element[RX_FIELD_VALUE];
+            bool is_bool = value->type == FOXDBG_JSON_TRUE || value->type == FOXDBG_JSON_FALSE;
+            bool valid = false;
+
+            switch (foxdbg_parameters_type(parameter))
+            {
+                case FOXDBG_PARAMETER_TYPE_FLOAT:
+                {
+                    valid = value->type == FOXDBG_JSON_NUMBER;
+                } break;
+
+                case FOXDBG_PARAMETER_TYPE_INTEGER:
+                {
+                    valid = value->type == FOXDBG_JSON_NUMBER && value->number == floor(value->number);
+                } break;
+
+                case FOXDBG_PARAMETER_TYPE_BOOLEAN:
+                {
+                    valid = is_bool;
+                } break;
+            }
+
+            if (!valid)
+            {
+                fprintf(stderr, "FOXDBG: Invalid value for parameter %s\n", name);
+                break;
+            }
+
+            message->parameter_ids[message->parameter_count] = parameter;
+            message->parameter_values[message->parameter_count] = is_bool ? (value->type == FOXDBG_JSON_TRUE ? 1.0 : 0.0) : value->number;
+            message->parameter_count++;
+        } break;
+
+        case RX_OP_SUBSCRIBE_PARAMETERS:
+        case RX_OP_UNSUBSCRIBE_PARAMETERS:
+        {
+            int parameter = rx_field_string(message, RX_FIELD_VALUE, name, sizeof(name)) ? foxdbg_parameters_find(name) : -1;
+
+            if (parameter >= 0)
+            {
+                parameter_subscribed[parameter] = message->op->op == RX_OP_SUBSCRIBE_PARAMETERS;
+                parameter_sent_version[parameter] = foxdbg_parameters_version(parameter);
+            }
+        } break;
+
+        default:
+        {
+            /* not handled */
+        } break;
+    }
+}
+
+/* whole number field within [min, max] */
+static bool rx_field_integer(const rx_message_t *message, rx_field_t field, int64_t min, int64_t max, int64_t *out)
+{
+    const foxdbg_json_event_t *event = &message->element[field];
+
+    if (!(message->fields & (1U << field)) || event->type != FOXDBG_JSON_NUMBER ||
+        event->number != floor(event->number) || event->number < (double)min || event->number > (double)max)
+    {
+        return false;
+    }
+
+    *out = (int64_t)event->number;
+    return true;
+}
+
+/* string field, unescaped and terminated in out */
+static bool rx_field_string(const rx_message_t *message, rx_field_t field, char *out, size_t out_size)
+{
+    const foxdbg_json_event_t *event = &message->element[field];
+
+    if (!(message->fields & (1U << field)) || event->type != FOXDBG_JSON_STRING)
+    {
+        return false;
+    }
+
+    return foxdbg_json_unescape(event->text, event->length, out, out_size) != (size_t)-1;
+}
+
+/* parameterValues reply to a get or set, echoing the request id */
+static void reply_parameters(const rx_message_t *message, bool all)
+{
+    json parameters = json::array();
+
+    if (all)
+    {
+        int count = foxdbg_parameters_count();
+
+        for (int parameter = 0; parameter < count; parameter++)
+        {
+            parameters.push_back(parameter_object(parameter));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < message->parameter_count; i++)
+        {
+            parameters.push_back(parameter_object(message->parameter_ids[i]));
+        }
+    }
+
+    json reply = {
+        {"op", "parameterValues"},
+        {"parameters", parameters}
+    };
+
+    if (message->has_request_id)
+    {
+        const foxdbg_json_event_t *id = &message->request_id;
+
+        if (id->type == FOXDBG_JSON_NUMBER && id->number == floor(id->number) && fabs(id->number) < 9007199254740992.0)
+        {
+            reply["id"] = (int64_t)id->number;
+        }
+        else if (id->type == FOXDBG_JSON_NUMBER)
+        {
+            reply["id"] = id->number;
+        }
+        else
+        {
+            std::string text(id->length + 1, '\0');
+            size_t length = foxdbg_json_unescape(id->text, id->length, &text[0], text.size());
+            text.resize(length == (size_t)-1 ? 0 : length);
+            reply["id"] = text;
+        }
+    }
+
+    send_json(reply);
+}
+
+/* opcode 0x01, client channel id (LE32), then the json message */
+static void receive_data(const uint8_t *data, size_t len)
+{
+    if (len < 5)
+    {
+        fprintf(stderr, "FOXDBG: Client message too short\n");
+        return;
+    }
+
+    uint32_t client_channel_id = (uint32_t)data[1] | ((uint32_t)data[2] << 8) |
+        ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 24);
+
+    auto it = client_channels.find(client_channel_id);
+
+    if (it == client_channels.end())
+    {
+        return; /* not advertised, or no rx channel for its topic */
+    }
+
+    foxdbg_channel_t *channel = it->second;
+    uint32_t value = 0;
+
+    if (!decode_rx_value(channel, (const char *)data + 5, len - 5, &value))
+    {
+        fprintf(stderr, "FOXDBG: Invalid client message for %s\n", channel->topic_name);
+        return;
+    }
+
+    uint64_t now = foxdbg_time_ns();
+
+    void *buffer;
+    size_t buffer_size;
+
+    foxdbg_buffer_begin_write(channel->data_buffer, &buffer, &buffer_size);
+    memcpy(buffer, &value, buffer_size);
+    foxdbg_buffer_set_timestamp(channel->data_buffer, now, now);
+    foxdbg_buffer_end_write(channel->data_buffer, buffer_size);
+
+    /* only this thread writes rx_latest, the sequence skips 0 so readers can tell nothing arrived */
+    uint32_t sequence = (uint32_t)(ATOMIC_READ_U64(&channel->rx_latest) >> 32) + 1;
+
+    if (sequence > INT32_MAX)
+    {
+        sequence = 1;
+    }
+
+    ATOMIC_WRITE_U64(&channel->rx_latest, ((uint64_t)sequence << 32) | value);
+
+    foxdbg_event_t event = {};
+    event.type = FOXDBG_EVENT_RX;
+    event.id = channel->channel_id;
+    event.rx_value = value;
+
+    foxdbg_events_push(&event);
+}
+
+static void push_subscription(foxdbg_channel_t *channel, bool subscribed)
+{
+    foxdbg_event_t event = {};
+    event.type = FOXDBG_EVENT_SUBSCRIPTION;
+    event.id = channel->channel_id;
+    event.subscribed = subscribed;
+
+    foxdbg_events_push(&event);
+}
+
+/* tell the client about subscribed parameters changed by either side since the last call */
+static void send_parameter_updates(void)
+{
+    uint32_t sequence = foxdbg_parameters_sequence();
+
+    if (!client || sequence == parameter_sequence_sent || (sequence & 1U))
+    {
+        return; /* nothing new, or a group is half written */
+    }
+
+    parameter_sequence_sent = sequence;
+
+    json parameters = json::array();
+    int count = foxdbg_parameters_count();
+
+    for (int parameter = 0; parameter < count; parameter++)
+    {
+        uint32_t version = foxdbg_parameters_version(parameter);
+
+        if (parameter_subscribed[parameter] && version != parameter_sent_version[parameter])
+        {
+            parameter_sent_version[parameter] = version;
+            parameters.push_back(parameter_object(parameter));
+        }
+    }
+
+    if (!parameters.empty())
+    {
+        json update = {
+            {"op", "parameterValues"},
+            {"parameters", parameters}
+        };
+
+        send_json(update);
+    }
+}
+
+static json parameter_object(int parameter)
+{
+    double value = foxdbg_parameters_read(parameter);
+
+    json object = {
+        {"name", foxdbg_parameters_name(parameter)}
+    };
+
+    switch (foxdbg_parameters_type(parameter))
+    {
+        case FOXDBG_PARAMETER_TYPE_FLOAT:
+        {
+            object["value"] = value;
+            object["type"] = "float64";
+        } break;
+
+        case FOXDBG_PARAMETER_TYPE_INTEGER:
+        {
+            object["value"] = (int64_t)value;
+        } break;
+
+        case FOXDBG_PARAMETER_TYPE_BOOLEAN:
+        {
+            object["value"] = value != 0.0;
+        } break;
+    }
+
+    return object;
+}
+
+static foxdbg_channel_t *find_rx_channel(const char *topic_name)
+{
+    foxdbg_channel_t *current = rx_channels ? *rx_channels : NULL;
+
+    while (current)
+    {
+        if (strcmp(current->topic_name, topic_name) == 0)
+        {
+            return current;
+        }
+
+        current = current->next;
+    }
+
+    return NULL;
+}
+
+/*
+ * find "value" in a {"value": ...} message (or take a bare scalar) and
+ * store it in the channel's representation. read in place, nothing is
+ * allocated on the way to the control loop.
+ */
+static bool decode_rx_value(foxdbg_channel_t *channel, const char *text, size_t len, uint32_t *value)
+{
+    rx_value_scan_t scan = { false, false, {} };
+
+    foxdbg_json_parse(text, len, find_value, &scan);
+
+    return scan.found && decode_rx_scalar(channel, &scan.value, value);
+}
+
+static bool find_value(void *context, const foxdbg_json_event_t *event)
+{
+    rx_value_scan_t *scan = (rx_value_scan_t *)context;
+
+    if (event->depth == 0 && event->type != FOXDBG_JSON_OBJECT_BEGIN && event->type != FOXDBG_JSON_OBJECT_END)
+    {
+        scan->value = *event;
+        scan->found = true;
+        return false;
+    }
+
+    if (event->depth != 1)
+    {
+        return true;
+    }
+
+    if (event->type == FOXDBG_JSON_KEY)
+    {
+        scan->at_value = foxdbg_json_equals(event, "value");
+        return true;
+    }
+
+    if (scan->at_value)
+    {
+        scan->value = *event;
+        scan->found = true;
+        return false;
+    }
+
+    return true;
+}
+
+static bool decode_rx_scalar(foxdbg_channel_t *channel, const foxdbg_json_event_t *event, uint32_t *value)
+{
+    bool is_bool = event->type == FOXDBG_JSON_TRUE || event->type == FOXDBG_JSON_FALSE;
+    bool is_number = event->type == FOXDBG_JSON_NUMBER;
+    double number = event->number;
+
+    *value = 0;
+
+    switch (channel->channel_type)
+    {
+        case FOXDBG_CHANNEL_TYPE_FLOAT:
+        {
+            if (!is_number)
+            {
+                return false;
+            }
+
+            float float_value = (float)number;
+            memcpy(value, &float_value, sizeof(float_value));
+        } break;
+
+        case FOXDBG_CHANNEL_TYPE_INTEGER:
+        {
+            if (!is_number || number != floor(number) || number < INT_MIN || number > INT_MAX)
+            {
+                return false;
+            }
+
+            int int_value = (int)number;
+            memcpy(value, &int_value, sizeof(int_value));
+        } break;
+
+        case FOXDBG_CHANNEL_TYPE_BOOLEAN:
+        {
+            if (!is_bool && !is_number)
+            {
+                return false;
+            }
+
+            bool flag = is_bool ? event->type == FOXDBG_JSON_TRUE : number != 0.0;
+            memcpy(value, &flag, sizeof(flag));
+        } break;
+
+        default:
+        {
+            return false;
+        } break;
+    }
+
+    return true;
+}
+
+static const char *channel_schema_name(foxdbg_channel_type_t channel_type)
+{
+    switch (channel_type)
+    {
+        case FOXDBG_CHANNEL_TYPE_IMAGE:
+        {
+            return "foxglove.CompressedImage";
+        }
+
+        case FOXDBG_CHANNEL_TYPE_POINTCLOUD:
+        {
+            return "foxglove.PointCloud";
+        }
+
+        case FOXDBG_CHANNEL_TYPE_CUBES:
+        {
+            return "foxglove.SceneUpdate";
+        }
+
+        case FOXDBG_CHANNEL_TYPE_LINES:
+        {
+            return "foxglove.SceneUpdate";
+        }
+
+        case FOXDBG_CHANNEL_TYPE_POSE:
+        {
+            return "foxglove.SceneUpdate";
+        }
+
+        case FOXDBG_CHANNEL_TYPE_SCENE:
+        case FOXDBG_CHANNEL_TYPE_SPHERES:
+        case FOXDBG_CHANNEL_TYPE_ARROWS:
+        case FOXDBG_CHANNEL_TYPE_TRIANGLES:
+        case FOXDBG_CHANNEL_TYPE_TEXT:
+        case FOXDBG_CHANNEL_TYPE_POSES:
+        case FOXDBG_CHANNEL_TYPE_PATH:
+        {
+            return "foxglove.SceneUpdate";
+        }
+
+        case FOXDBG_CHANNEL_TYPE_TRANSFORM:
+        {
+            return "foxglove.FrameTransform";
+        }
+
+        case FOXDBG_CHANNEL_TYPE_TRANSFORMS:
+        {
+            return "foxglove.FrameTransforms";
+        }
+
+        case FOXDBG_CHANNEL_TYPE_LOCATION:
+        {
+            return "foxglove.LocationFix";
+        }
+
+        case FOXDBG_CHANNEL_TYPE_FLOAT:
+        {
+            return "foxdbg.Float";
+        }
+
+        case FOXDBG_CHANNEL_TYPE_INTEGER:
+        {
+            return "foxdbg.Integer";
+        }
+
+        case FOXDBG_CHANNEL_TYPE_BOOLEAN:
+        {
+            return "foxdbg.Boolean";
+        }
+
+        case FOXDBG_CHANNEL_TYPE_STATS:
+        {
+            return "foxdbg.Stats";
+        }
+
+        default:
+        {
+            return "foxglove.Unknown";
+        }
+    }
+}
+
+/* json schema for the foxdbg types, empty for the foxglove ones. built once */
+static const std::string &channel_schema(foxdbg_channel_type_t channel_type)
+{
+    static const std::string none;
+
+    switch (channel_type)
+    {
+        case FOXDBG_CHANNEL_TYPE_FLOAT:
+        {
+            static const std::string custom_schema = json({
+                {"title", "foxdbg.Float"},
+                {"description", "float value"},
+                {"type", "object"},
+                {"properties", {
+                    {"value", {
+                        {"type", "number"},
+                        {"description", "float value"}
+                    }}
+                }}
+            }).dump();
+
+            return custom_schema;
+        }
+
+        case FOXDBG_CHANNEL_TYPE_INTEGER:
+        {
+            static const std::string custom_schema = json({
+                {"title", "foxdbg.Integer"},
+                {"description", "float value"},
+                {"type", "object"},
+                {"properties", {
+                    {"value", {
+                        {"type", "integer"},
+                        {"description", "int value"}
+                    }}
+                }}
+            }).dump();
+
+            return custom_schema;
+        }
+
+        case FOXDBG_CHANNEL_TYPE_BOOLEAN:
+        {
+            static const std::string custom_schema = json({
+                {"title", "foxdbg.Boolean"},
+                {"description", "bool value"},
+                {"type", "object"},
+                {"properties", {
+                    {"value", {
+                        {"type", "boolean"},
+                        {"description", "bool value"}
+                    }}
+                }}
+            }).dump();
+
+            return custom_schema;
+        }
+
+        case FOXDBG_CHANNEL_TYPE_STATS:
+        {
+            static const json duration_schema = {
+                {"type", "object"},
+                {"description", "bucketed, percentiles are the upper bound of their bucket"},
+                {"properties", {
+                    {"count", {{"type", "integer"}}},
+                    {"mean", {{"type", "number"}}},
+                    {"p50", {{"type", "integer"}}},
+                    {"p90", {{"type", "integer"}}},
+                    {"p99", {{"type", "integer"}}}
+                }}
+            };
+
+            static const std::string custom_schema = json({
+                {"title", "foxdbg.Stats"},
+                {"description", "server counters, rates and percentiles cover interval_ms"},
+                {"type", "object"},
+                {"properties", {
+                    {"timestamp", {
+                        {"type", "object"},
+                        {"properties", {
+                            {"sec", {{"type", "integer"}}},
+                            {"nsec", {{"type", "integer"}}}
+                        }}
+                    }},
+                    {"interval_ms", {{"type", "number"}, {"description", "time since the last report"}}},
+                    {"socket_queued_bytes", {{"type", "integer"}, {"description", "bytes waiting in the kernel to be sent to the client, Linux only"}}},
+                    {"socket_partial", {{"type", "boolean"}, {"description", "libwebsockets holds part of a message the socket would not take"}}},
+                    {"channels", {
+                        {"type", "array"},
+                        {"items", {
+                            {"type", "object"},
+                            {"properties", {
+                                {"topic", {{"type", "string"}}},
+                                {"subscribed", {{"type", "boolean"}}},
+                                {"write_hz", {{"type", "number"}, {"description", "payloads written by the application"}}},
+                                {"send_hz", {{"type", "number"}, {"description", "messages sent to the client"}}},
+                                {"bytes_per_s", {{"type", "number"}, {"description", "bytes sent to the client"}}},
+                                {"writes", {{"type", "integer"}, {"description", "total payloads written"}}},
+                                {"messages_sent", {{"type", "integer"}, {"description", "total messages sent"}}},
+                                {"bytes_sent", {{"type", "integer"}, {"description", "total bytes sent"}}},
+                                {"dropped_writes", {{"type", "integer"}, {"description", "total payloads larger than the channel buffer"}}},
+                                {"dropped_sends", {{"type", "integer"}, {"description", "total payloads too large to encode or send"}}},
+                                {"encode_us", duration_schema},
+                                {"age_us", duration_schema}
+                            }}
+                        }}
+                    }}
+                }}
+            }).dump();
+
+            return custom_schema;
+        }
+
+        default:
+        {
+            /* well known foxglove schema */
+            return none;
+        }
+    }
+}
+
+static void send_image(foxdbg_channel_t *channel)
+{
+    void *data;
+    size_t data_size;
+    begin_payload(channel, &data, &data_size);
+
+    size_t image_size = data_size;
+
+    if (data_size <= sizeof(raw_data_buffer) && data_size > 0)
+    {
+        memcpy(raw_data_buffer, data, data_size);
+        foxdbg_buffer_end_read(channel->data_buffer);
+    }
+    else 
+    {
+        foxdbg_buffer_end_read(channel->data_buffer);
+        return;
+    }
+
+
+    foxdbg_buffer_begin_read(channel->info_buffer, &data, &data_size);
+
+    /* a short or missing info would leave another channel's bytes in info_data_buffer */
+    if (data_size == sizeof(foxdbg_image_info_t))
+    {
+        memcpy(info_data_buffer, data, data_size);
+        foxdbg_buffer_end_read(channel->info_buffer);
+    }
+    else 
+    {
+        foxdbg_buffer_end_read(channel->info_buffer);
+        return;
+    }
+
+    foxdbg_image_info_t *image_info = (foxdbg_image_info_t*)info_data_buffer;
+    foxdbg_pixel_format_t format = foxdbg_image_pixel_format(image_info);
+
+    size_t compressedSize = 0;
+    const unsigned char* compressedImage = NULL;
+    const char *encoding = "jpeg";
+
+    if (foxdbg_image_is_compressed(format))
+    {
+        /* producer already delivered a bitstream, forward it untouched */
+        compressedImage = raw_data_buffer;
+        compressedSize = image_size;
+        encoding = (format == FOXDBG_PIXEL_FORMAT_PNG) ? "png" : "jpeg";
+    }
+    else if (!foxdbg_encoder_compress(image_info, raw_data_buffer, image_size, channel->jpeg_slices, &compressedImage, &compressedSize))
+    {
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    /* serialise straight into the outgoing frame, behind the lws and message headers */
+    size_t bytes_written = encode_image_byte_array(
+        (uint8_t*)tx_buffer + LWS_PRE + 13, 
+        tx_buffer_size - LWS_PRE - 13, 
+        image_info->width,
+        image_info->height,
+        image_info->channels,
+        encoding,
+        compressedImage, 
+        compressedSize
+    );
+
+
+    if (bytes_written > 0)
+    {
+        send_buffer(
+            (uint8_t*)tx_buffer + LWS_PRE, 
+            tx_buffer_size, 
+            bytes_written + 13,
+            subscription_id
+        );
+    }
+}
+
+static void send_pointcloud(foxdbg_channel_t *channel)
+{
+    void *data;
+    size_t data_size;
+    begin_payload(channel, &data, &data_size);
+
+    if (data_size <= sizeof(raw_data_buffer) && data_size > 0)
+    {
+        memcpy(raw_data_buffer, data, data_size);
+        foxdbg_buffer_end_read(channel->data_buffer);
+    }
+    else 
+    {
+        foxdbg_buffer_end_read(channel->data_buffer);
+        return;
+    }
+
+    /* optional layout descriptor, foxdbg_vector4_t points without one */
+    foxdbg_pointcloud_info_t *info = NULL;
+
+    void *info_data;
+    size_t info_size;
+    foxdbg_buffer_begin_read(channel->info_buffer, &info_data, &info_size);
+
+    if (info_size == sizeof(foxdbg_pointcloud_info_t))
+    {
+        memcpy(info_data_buffer, info_data, info_size);
+        info = (foxdbg_pointcloud_info_t*)info_data_buffer;
+    }
+
+    foxdbg_buffer_end_read(channel->info_buffer);
+
+    size_t point_stride = info ? info->point_stride : sizeof(foxdbg_vector4_t);
+
+    if (point_stride == 0 || data_size % point_stride != 0)
+    {
+        return;
+    }
+
+    bool is_vector4 = foxdbg_pointcloud_is_vector4(info);
+
+    if ((channel->voxel_size > 0.0f || channel->point_budget > 0) && is_vector4)
+    {
+        size_t point_count = foxdbg_pointcloud_downsample(
+            (foxdbg_vector4_t *)raw_data_buffer,
+            data_size / sizeof(foxdbg_vector4_t),
+            channel->voxel_size,
+            channel->point_budget
+        );
+
+        data_size = point_count * sizeof(foxdbg_vector4_t);
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    /* legacy clouds sit 0.6 m above the world origin */
+    foxdbg_vector3_t position = { 0.0f, 0.0f, 0.6f };
+    foxdbg_vector4_t rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+    if (info)
+    {
+        position = info->position;
+        foxdbg_math_euler_to_quaternion(&info->orientation, sizeof(foxdbg_vector3_t), 0.0f, &rotation, 1);
+    }
+
+    float qx = rotation.x, qy = rotation.y, qz = rotation.z, qw = rotation.w;
+
+    json j;
+    j["timestamp"] = timestamp_object();
+
+    if (channel->quantize && is_vector4)
+    {
+        foxdbg_vector3_t offset;
+        data_size = foxdbg_pointcloud_quantize(
+            (foxdbg_vector4_t *)raw_data_buffer,
+            data_size / sizeof(foxdbg_vector4_t),
+            &offset
+        );
+        point_stride = FOXDBG_QUANTIZED_POINT_STRIDE;
+
+        /* points are relative to offset now, move it into the pose: p += q * offset * q' */
+        float tx = 2.0f * (qy * offset.z - qz * offset.y);
+        float ty = 2.0f * (qz * offset.x - qx * offset.z);
+        float tz = 2.0f * (qx * offset.y - qy * offset.x);
+
+        position.x += offset.x + qw * tx + (qy * tz - qz * ty);
+        position.y += offset.y + qw * ty + (qz * tx - qx * tz);
+        position.z += offset.z + qw * tz + (qx * ty - qy * tx);
+
+        bool has_intensity = !info || info->field_count > 3;
+
+        j["fields"] = {
+            {{"name", "x"}, {"offset", 0}, {"type", FOXDBG_FIELD_TYPE_FLOAT32}},
+            {{"name", "y"}, {"offset", 4}, {"type", FOXDBG_FIELD_TYPE_FLOAT32}},
+            {{"name", "z"}, {"offset", 8}, {"type", FOXDBG_FIELD_TYPE_FLOAT32}}
+        };
+
+        if (has_intensity)
+        {
+            const char *name = info ? info->fields[3].name : "intensity";
+
+            j["fields"].push_back({
+                {"name", std::string(name, strnlen(name, FOXDBG_FIELD_NAME_LENGTH))},
+                {"offset", 12},
+                {"type", FOXDBG_FIELD_TYPE_UINT8}
+            });
+        }
+    }
+    else if (info)
+    {
+        j["fields"] = json::array();
+
+        for (uint32_t i = 0; i < info->field_count && i < FOXDBG_POINTCLOUD_MAX_FIELDS; i++)
+        {
+            const foxdbg_pointcloud_field_t *field = &info->fields[i];
+
+            j["fields"].push_back({
+                {"name", std::string(field->name, strnlen(field->name, FOXDBG_FIELD_NAME_LENGTH))},
+                {"offset", field->offset},
+                {"type", (int)field->type}
+            });
+        }
+    }
+    else
+    {
+        j["fields"] = {
+            {{"name", "x"}, {"offset", 0}, {"type", 7}},
+            {{"name", "y"}, {"offset", 4}, {"type", 7}},
+            {{"name", "z"}, {"offset", 8}, {"type", 7}},
+            {{"name", "intensity"}, {"offset", 12}, {"type", 7}}
+        };
+    }
+
+    if (info)
+    {
+        j["frame_id"] = std::string(info->frame_id, strnlen(info->frame_id, FOXDBG_FRAME_ID_LENGTH));
+    }
+    else
+    {
+        j["frame_id"] = "world";
+    }
+
+    j["pose"]["position"] = {
+        {"x", position.x},
+        {"y", position.y},
+        {"z", position.z}
+    };
+
+    j["pose"]["orientation"] = {
+        {"x", qx},
+        {"y", qy},
+        {"z", qz},
+        {"w", qw}
+    };
+
+    j["point_stride"] = point_stride;
+
+    /* metadata goes through nlohmann, the points are copied straight into the tx buffer */
+    std::string header = j.dump();
+    header.back() = ',';
+    header += "\"data\":";
+
+    uint8_t *message = tx_buffer + LWS_PRE + 13;
+    size_t message_capacity = tx_buffer_size - LWS_PRE - 13;
+
+    if (header.size() + 1 >= message_capacity)
+    {
+        drop_payload(channel, "Point cloud message too large for buffer");
+        return;
+    }
+
+    memcpy(message, header.c_str(), header.size());
+
+    size_t array_size = encode_byte_array(
+        message + header.size(),
+        message_capacity - header.size() - 1,
+        raw_data_buffer, data_size
+    );
+
+    if (array_size == 0)
+    {
+        drop_payload(channel, "Point cloud message too large for buffer");
+        return;
+    }
+
+    size_t message_size = header.size() + array_size;
+    message[message_size++] = '}';
+
+    send_buffer(
+        (uint8_t*)tx_buffer + LWS_PRE, 
+        tx_buffer_size, 
+        message_size + 13,
+        subscription_id
+    );
+}
+
+static void send_cubes(foxdbg_channel_t *channel)
+{
+    size_t numCubes;
+
+    if (!read_array(channel, sizeof(foxdbg_cube_t), &numCubes))
+    {
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    foxdbg_cube_t *cubes = (foxdbg_cube_t*)raw_data_buffer;
+
+    orientation_buffer.resize(numCubes);
+    foxdbg_math_euler_to_quaternion(
+        &cubes[0].orientation, sizeof(foxdbg_cube_t),
+        FOXDBG_MARKER_YAW_OFFSET,
+        orientation_buffer.data(), numCubes
+    );
+
+    json entity = channel_entity(channel);
+    entity["cubes"] = json::array();
+
+    for (size_t i = 0; i < numCubes; ++i)
+    {
+        entity["cubes"].push_back(cube_object(&cubes[i], &orientation_buffer[i]));
+    }
+
+    send_entity(entity, subscription_id);
+}
+
+static void send_lines(foxdbg_channel_t *channel)
+{
+    size_t numLines;
+
+    if (!read_array(channel, sizeof(foxdbg_line_t), &numLines))
+    {
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    foxdbg_line_t *lines = (foxdbg_line_t*)raw_data_buffer;
+
+    json entity = channel_entity(channel);
+    entity["lines"] = line_list_objects(lines, numLines);
+
+    send_entity(entity, subscription_id);
+}
+
+static void send_pose(foxdbg_channel_t *channel)
+{
+    void *data;
+    size_t data_size;
+    begin_payload(channel, &data, &data_size);
+
+    if (data_size <= sizeof(raw_data_buffer) && data_size == sizeof(foxdbg_pose_t))
+    {
+        memcpy(raw_data_buffer, data, data_size);
+        foxdbg_buffer_end_read(channel->data_buffer);
+    }
+    else 
+    {
+        foxdbg_buffer_end_read(channel->data_buffer);
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    foxdbg_pose_t *pose = (foxdbg_pose_t*)raw_data_buffer;
+
+    foxdbg_vector4_t orientation;
+    foxdbg_math_euler_to_quaternion(&pose->orientation, sizeof(foxdbg_pose_t), FOXDBG_MARKER_YAW_OFFSET, &orientation, 1);
+
+    json entity = channel_entity(channel);
+    entity["arrows"] = json::array({arrow_object(pose, &orientation)});
+
+    send_entity(entity, subscription_id);
+}
+
+static void send_transform(foxdbg_channel_t *channel)
+{
+    void *data;
+    size_t data_size;
+    begin_payload(channel, &data, &data_size);
+
+    if (data_size <= sizeof(raw_data_buffer) && data_size == sizeof(foxdbg_frame_transform_t))
+    {
+        memcpy(raw_data_buffer, data, data_size);
+        foxdbg_buffer_end_read(channel->data_buffer);
+    }
+    else 
+    {
+        foxdbg_buffer_end_read(channel->data_buffer);
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    foxdbg_frame_transform_t *transform = (foxdbg_frame_transform_t*)raw_data_buffer;
+
+    foxdbg_vector4_t rotation;
+    foxdbg_math_euler_to_quaternion(&transform->orientation, sizeof(foxdbg_frame_transform_t), 0.0f, &rotation, 1);
+
+    std::string json_str = frame_transform_object(transform, &rotation).dump();
+    size_t json_len = json_str.length();
+
+    if (json_len + LWS_PRE + 13 < sizeof(tx_buffer))
+    {
+        memcpy(tx_buffer + LWS_PRE + 13, json_str.c_str(), json_len);
+
+        send_buffer(
+            (uint8_t*)tx_buffer + LWS_PRE, 
+            tx_buffer_size, 
+            json_len + 13,
+            subscription_id
+        );
+    }
+}
+
+static void send_location(foxdbg_channel_t *channel)
+{
+    void *data;
+    size_t data_size;
+    begin_payload(channel, &data, &data_size);
+
+    if (data_size <= sizeof(raw_data_buffer) && data_size == sizeof(foxdbg_location_t))
+    {
+        memcpy(raw_data_buffer, data, data_size);
+        foxdbg_buffer_end_read(channel->data_buffer);
+    }
+    else 
+    {
+        foxdbg_buffer_end_read(channel->data_buffer);
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    foxdbg_location_t *location = (foxdbg_location_t*)raw_data_buffer;
+
+    json json_data = {
+        {"timestamp", {
+            {"sec", location->timestamp_sec},
+            {"nsec", location->timestamp_nsec}
+        }},
+        {"frame_id", "world"},
+        {"latitude", location->latitude},
+        {"longitude", location->longitude},
+        {"altitude", location->altitude}
+    };
+
+    json_data["position_covariance"] = std::vector<double>(9, 0.0);
+    json_data["position_covariance_type"] = 0;
+
+    std::string json_str = json_data.dump();
+    size_t json_len = json_str.length();
+
+    if (json_len + LWS_PRE + 13 < sizeof(tx_buffer))
+    {
+        memcpy(tx_buffer + LWS_PRE + 13, json_str.c_str(), json_len);
 
-    if (data_size <= sizeof(raw_data_buffer) && data_size > 0)
+        send_buffer(
+            (uint8_t*)tx_buffer + LWS_PRE, 
+            tx_buffer_size, 
+            json_len + 13,
+            subscription_id
+        );
+    }
+}
+
+static void send_float(foxdbg_channel_t *channel)
+{
+
+    void *data;
+    size_t data_size;
+    begin_payload(channel, (void**)&data, &data_size);
+
+    if (data_size <= sizeof(raw_data_buffer) && data_size == sizeof(float))
     {
         memcpy(raw_data_buffer, data, data_size);
         foxdbg_buffer_end_read(channel->data_buffer);
@@ -615,143 +2454,534 @@ static void send_image(foxdbg_channel_t *channel)
         return;
     }
 
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
 
-    foxdbg_buffer_begin_read(channel->info_buffer, &data, &data_size);
+    float *raw = (float*)raw_data_buffer;
+
+    json json_data = {
+        {"value", (*raw)}
+    };
+
+    std::string json_str = json_data.dump();
+    size_t json_len = json_str.length();
+
+    if (json_len + LWS_PRE + 13 < sizeof(tx_buffer))
+    {
+        memcpy(tx_buffer + LWS_PRE + 13, json_str.c_str(), json_len);
+
+        send_buffer(
+            (uint8_t*)tx_buffer + LWS_PRE, 
+            tx_buffer_size, 
+            json_len + 13,
+            subscription_id
+        );
+    }
+    
+}
+
+static void send_integer(foxdbg_channel_t *channel)
+{
+    void *data;
+    size_t data_size;
+    begin_payload(channel, (void**)&data, &data_size);
+
+    if (data_size <= sizeof(raw_data_buffer) && data_size == sizeof(int))
+    {
+        memcpy(raw_data_buffer, data, data_size);
+        foxdbg_buffer_end_read(channel->data_buffer);
+    }
+    else 
+    {
+        foxdbg_buffer_end_read(channel->data_buffer);
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    int *raw = (int*)raw_data_buffer;
+
+    json json_data = {
+        {"value", (*raw)}
+    };
+
+    std::string json_str = json_data.dump();
+    size_t json_len = json_str.length();
+
+    if (json_len + LWS_PRE + 13 < sizeof(tx_buffer))
+    {
+        memcpy(tx_buffer + LWS_PRE + 13, json_str.c_str(), json_len);
+
+        send_buffer(
+            (uint8_t*)tx_buffer + LWS_PRE, 
+            tx_buffer_size, 
+            json_len + 13,
+            subscription_id
+        );
+    }
+}
+
+
+static void send_bool(foxdbg_channel_t *channel)
+{
+    void *data;
+    size_t data_size;
+    begin_payload(channel, (void**)&data, &data_size);
+
+    if (data_size <= sizeof(raw_data_buffer) && data_size == sizeof(bool))
+    {
+        memcpy(raw_data_buffer, data, data_size);
+        foxdbg_buffer_end_read(channel->data_buffer);
+    }
+    else 
+    {
+        foxdbg_buffer_end_read(channel->data_buffer);
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    bool *raw = (bool*)raw_data_buffer;
+
+    json json_data = {
+        {"value", (*raw)}
+    };
+
+    std::string json_str = json_data.dump();
+    size_t json_len = json_str.length();
+
+    if (json_len + LWS_PRE + 13 < sizeof(tx_buffer))
+    {
+        memcpy(tx_buffer + LWS_PRE + 13, json_str.c_str(), json_len);
+
+        send_buffer(
+            (uint8_t*)tx_buffer + LWS_PRE, 
+            tx_buffer_size, 
+            json_len + 13,
+            subscription_id
+        );
+    }
+}
+
+
+static void send_spheres(foxdbg_channel_t *channel)
+{
+    size_t count;
+
+    if (!read_array(channel, sizeof(foxdbg_sphere_t), &count))
+    {
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    const foxdbg_sphere_t *spheres = (const foxdbg_sphere_t *)raw_data_buffer;
+
+    json entity = channel_entity(channel);
+    entity["spheres"] = json::array();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        entity["spheres"].push_back(sphere_object(&spheres[i]));
+    }
+
+    send_entity(entity, subscription_id);
+}
+
+static void send_arrows(foxdbg_channel_t *channel)
+{
+    size_t count;
+
+    if (!read_array(channel, sizeof(foxdbg_arrow_t), &count))
+    {
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    const foxdbg_arrow_t *arrows = (const foxdbg_arrow_t *)raw_data_buffer;
+
+    orientation_buffer.resize(count);
+    foxdbg_math_euler_to_quaternion(
+        &arrows[0].orientation, sizeof(foxdbg_arrow_t),
+        FOXDBG_MARKER_YAW_OFFSET,
+        orientation_buffer.data(), count
+    );
+
+    json entity = channel_entity(channel);
+    entity["arrows"] = json::array();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        entity["arrows"].push_back(arrow_array_object(&arrows[i], &orientation_buffer[i]));
+    }
+
+    send_entity(entity, subscription_id);
+}
+
+static void send_triangles(foxdbg_channel_t *channel)
+{
+    size_t count;
+
+    if (!read_array(channel, sizeof(foxdbg_triangle_t), &count))
+    {
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    json entity = channel_entity(channel);
+    entity["triangles"] = json::array({
+        triangle_list_object((const foxdbg_triangle_t *)raw_data_buffer, count)
+    });
+
+    send_entity(entity, subscription_id);
+}
+
+static void send_text(foxdbg_channel_t *channel)
+{
+    size_t count;
+
+    if (!read_array(channel, sizeof(foxdbg_text_t), &count))
+    {
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    const foxdbg_text_t *texts = (const foxdbg_text_t *)raw_data_buffer;
+
+    json entity = channel_entity(channel);
+    entity["texts"] = json::array();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        entity["texts"].push_back(text_object(&texts[i]));
+    }
+
+    send_entity(entity, subscription_id);
+}
+
+static void send_poses(foxdbg_channel_t *channel)
+{
+    size_t count;
+
+    if (!read_array(channel, sizeof(foxdbg_pose_t), &count))
+    {
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    const foxdbg_pose_t *poses = (const foxdbg_pose_t *)raw_data_buffer;
+
+    orientation_buffer.resize(count);
+    foxdbg_math_euler_to_quaternion(
+        &poses[0].orientation, sizeof(foxdbg_pose_t),
+        FOXDBG_MARKER_YAW_OFFSET,
+        orientation_buffer.data(), count
+    );
+
+    json entity = channel_entity(channel);
+    entity["arrows"] = json::array();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        entity["arrows"].push_back(arrow_object(&poses[i], &orientation_buffer[i]));
+    }
+
+    send_entity(entity, subscription_id);
+}
+
+/* history as one line strip in the colour of the newest pose, with an arrow at the tip */
+static void send_path(foxdbg_channel_t *channel)
+{
+    size_t count;
+
+    if (!read_array(channel, sizeof(foxdbg_pose_t), &count))
+    {
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    const foxdbg_pose_t *poses = (const foxdbg_pose_t *)raw_data_buffer;
+    const foxdbg_pose_t *tip = &poses[count - 1];
+
+    json points = json::array();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        points.push_back({
+            {"x", poses[i].position.x},
+            {"y", poses[i].position.y},
+            {"z", poses[i].position.z}
+        });
+    }
+
+    json line_strip;
+    line_strip["type"] = 0; /* LINE_STRIP */
+    line_strip["pose"]["position"] = {
+        {"x", 0.0f}, {"y", 0.0f}, {"z", 0.0f}
+    };
+    line_strip["pose"]["orientation"] = {
+        {"x", 0.0f}, {"y", 0.0f}, {"z", 0.0f}, {"w", 1.0f}
+    };
+    line_strip["thickness"] = PATH_THICKNESS;
+    line_strip["scale_invariant"] = false;
+    line_strip["points"] = std::move(points);
+    line_strip["color"] = color_object(&tip->color);
+
+    foxdbg_vector4_t orientation;
+    foxdbg_math_euler_to_quaternion(&tip->orientation, sizeof(foxdbg_pose_t), FOXDBG_MARKER_YAW_OFFSET, &orientation, 1);
+
+    json entity = channel_entity(channel);
+    entity["lines"] = json::array({line_strip});
+    entity["arrows"] = json::array({arrow_object(tip, &orientation)});
+
+    send_entity(entity, subscription_id);
+}
+
+/*
+ * the whole tree in one FrameTransforms message. static transforms go out
+ * once per subscription, dynamic ones when they moved past the channel's
+ * thresholds, and all of them again every keepalive period.
+ */
+static void send_transforms(foxdbg_channel_t *channel)
+{
+    size_t count;
+
+    if (!read_array(channel, sizeof(foxdbg_frame_transform_t), &count))
+    {
+        return;
+    }
+
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+
+    transform_state_t *state = (transform_state_t *)channel->protocol_state;
+
+    if (!state)
+    {
+        state = new transform_state_t();
+        state->subscription_id = -1;
+        state->refresh_time = 0;
+        channel->protocol_state = state;
+    }
+
+    uint64_t current_time = current_timestamp_ms();
+
+    /* a new subscriber holds nothing yet, the recording only ever has the one */
+    int owner = payload_to_client ? subscription_id : -1;
+
+    if (state->subscription_id != owner)
+    {
+        state->sent.clear();
+        state->subscription_id = owner;
+        state->refresh_time = current_time;
+    }
+
+    bool refresh = channel->keepalive_time > 0 && (current_time - state->refresh_time) >= channel->keepalive_time;
+
+    const foxdbg_frame_transform_t *transforms = (const foxdbg_frame_transform_t *)raw_data_buffer;
+
+    orientation_buffer.resize(count);
+    foxdbg_math_euler_to_quaternion(
+        &transforms[0].orientation, sizeof(foxdbg_frame_transform_t),
+        0.0f,
+        orientation_buffer.data(), count
+    );
+
+    json message;
+    message["transforms"] = json::array();
+
+    /* kept in the state once the message is sent */
+    std::vector<std::pair<int, sent_transform_t>> updates;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const foxdbg_frame_transform_t *transform = &transforms[i];
+        const foxdbg_vector4_t *rotation = &orientation_buffer[i];
+
+        if (!foxdbg_frames_name(transform->frame) || !foxdbg_frames_name(transform->parent))
+        {
+            continue; /* not interned */
+        }
+
+        auto sent = state->sent.find(transform->frame);
+
+        if (sent != state->sent.end())
+        {
+            bool moved = !transform->is_static && transform_moved(channel, &sent->second, transform, rotation);
+
+            if (!refresh && !moved)
+            {
+                continue;
+            }
+        }
 
-    if (data_size <= sizeof(info_data_buffer))
-    {
-        memcpy(info_data_buffer, data, data_size);
-        foxdbg_buffer_end_read(channel->info_buffer);
+        updates.push_back({ transform->frame, { transform->position, *rotation } });
+        message["transforms"].push_back(frame_transform_object(transform, rotation));
     }
-    else 
+
+    if (message["transforms"].empty())
     {
-        foxdbg_buffer_end_read(channel->info_buffer);
         return;
     }
 
-    int pixelFormat = TJPF_RGB;
+    std::string json_str = message.dump();
+    size_t json_len = json_str.length();
 
-    if (((foxdbg_image_info_t*)info_data_buffer)->channels == 1)
-    {
-        pixelFormat = TJPF_GRAY;
-    }
-    else if (((foxdbg_image_info_t*)info_data_buffer)->channels == 3)
+    if (json_len + LWS_PRE + 13 < sizeof(tx_buffer))
     {
-        pixelFormat = TJPF_RGB;
+        memcpy(tx_buffer + LWS_PRE + 13, json_str.c_str(), json_len);
+
+        bool sent = send_buffer(
+            (uint8_t*)tx_buffer + LWS_PRE, 
+            tx_buffer_size, 
+            json_len + 13,
+            subscription_id
+        );
+
+        if (sent)
+        {
+            for (const auto &update : updates)
+            {
+                state->sent[update.first] = update.second;
+            }
+
+            if (refresh)
+            {
+                state->refresh_time = current_time;
+            }
+        }
     }
-    else if (((foxdbg_image_info_t*)info_data_buffer)->channels == 4)
+    else
     {
-        pixelFormat = TJPF_RGBA;
+        drop_payload(channel, "Transforms message too large for buffer");
     }
+}
 
-    unsigned long compressedSize = 0;
-    unsigned char* compressedImage = NULL;
+/* the counters of every channel, as rates and percentiles over the time since the last report */
+static void send_stats(foxdbg_channel_t *channel)
+{
+    uint64_t now = foxdbg_time_ns();
+    double interval = (double)(now - stats_last_time) / 1e9;
+    stats_last_time = now;
 
-    int result = tjCompress2(
-        jpeg_handle,
-        raw_data_buffer,
-        ((foxdbg_image_info_t*)info_data_buffer)->width,
-        0, // Pitch
-        ((foxdbg_image_info_t*)info_data_buffer)->height,
-        pixelFormat,
-        &compressedImage,
-        &compressedSize,
-        jpegSubsamp,
-        jpegQuality,
-        TJFLAG_FASTDCT
-    );
+    json stats_channels = json::array();
 
-    if (result != 0)
+    for (foxdbg_channel_t *current = *channels; current; current = current->next)
     {
-        fprintf(stderr, "Failed to compress image: %s\n", tjGetErrorStr());
-        return;
-    }
+        stats_snapshot_t snapshot = {
+            ATOMIC_READ_U64(&current->write_count),
+            current->send_count,
+            current->send_bytes,
+            current->encode_time,
+            current->latency
+        };
 
-    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+        stats_snapshot_t &last = stats_last[current->channel_id];
 
+        stats_channels.push_back({
+            {"topic", current->topic_name},
+            {"subscribed", ATOMIC_READ_INT(&current->subscription_id) >= 0},
+            {"write_hz", interval > 0.0 ? (double)(snapshot.write_count - last.write_count) / interval : 0.0},
+            {"send_hz", interval > 0.0 ? (double)(snapshot.send_count - last.send_count) / interval : 0.0},
+            {"bytes_per_s", interval > 0.0 ? (double)(snapshot.send_bytes - last.send_bytes) / interval : 0.0},
+            {"writes", snapshot.write_count},
+            {"messages_sent", snapshot.send_count},
+            {"bytes_sent", snapshot.send_bytes},
+            {"dropped_writes", ATOMIC_READ_U64(&current->write_dropped)},
+            {"dropped_sends", current->send_dropped},
+            {"encode_us", duration_object(&snapshot.encode_time, &last.encode_time)},
+            {"age_us", duration_object(&snapshot.latency, &last.latency)}
+        });
 
+        last = snapshot;
+    }
 
+    payload_channel = channel;
+    payload_timestamp = now;
+    payload_write_time = 0;
 
-    size_t bytes_written = encode_image_byte_array(
-        encode_buffer, 
-        encode_buffer_size, 
-        ((foxdbg_image_info_t*)info_data_buffer)->width,
-        ((foxdbg_image_info_t*)info_data_buffer)->height,
-        ((foxdbg_image_info_t*)info_data_buffer)->channels,
-        compressedImage, 
-        compressedSize
-    );
+    json stats = {
+        {"timestamp", timestamp_object()},
+        {"interval_ms", interval * 1000.0},
+        {"socket_queued_bytes", socket_queued_bytes()},
+        {"socket_partial", client && lws_partial_buffered(client)},
+        {"channels", stats_channels}
+    };
 
+    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
 
-    if (tx_buffer_size >= (bytes_written + LWS_PRE + 13))
-    {
-        memcpy((uint8_t*)tx_buffer + LWS_PRE + 13, encode_buffer, bytes_written);
+    std::string json_str = stats.dump();
+    size_t json_len = json_str.length();
 
+    if (json_len + LWS_PRE + 13 < sizeof(tx_buffer))
+    {
+        memcpy(tx_buffer + LWS_PRE + 13, json_str.c_str(), json_len);
 
         send_buffer(
             (uint8_t*)tx_buffer + LWS_PRE, 
             tx_buffer_size, 
-            bytes_written + 13,
+            json_len + 13,
             subscription_id
         );
     }
+    else
+    {
+        drop_payload(channel, "Stats message too large for buffer");
+    }
+}
 
+/* begin_read on the channel's data, remembering its timestamps for the messages built from it */
+static void begin_payload(foxdbg_channel_t *channel, void **data, size_t *data_size)
+{
+    foxdbg_buffer_begin_read(channel->data_buffer, data, data_size);
 
-    tjFree(compressedImage);
+    payload_channel = channel;
+    payload_timestamp = foxdbg_buffer_get_timestamp(channel->data_buffer);
+    payload_write_time = foxdbg_buffer_get_write_time(channel->data_buffer);
+    payload_hash = foxdbg_buffer_get_hash(channel->data_buffer);
 }
 
-static void send_pointcloud(foxdbg_channel_t *channel)
+/* copy a whole number of elements out of the channel, false if empty or malformed */
+static bool read_array(foxdbg_channel_t *channel, size_t element_size, size_t *count)
 {
     void *data;
     size_t data_size;
-    foxdbg_buffer_begin_read(channel->data_buffer, &data, &data_size);
+    begin_payload(channel, &data, &data_size);
 
-    if (data_size <= sizeof(raw_data_buffer) && data_size > 0 && data_size % sizeof(foxdbg_vector4_t) == 0)
+    if (data_size <= sizeof(raw_data_buffer) && data_size > 0 && data_size % element_size == 0)
     {
         memcpy(raw_data_buffer, data, data_size);
         foxdbg_buffer_end_read(channel->data_buffer);
-    }
-    else 
-    {
-        foxdbg_buffer_end_read(channel->data_buffer);
-        return;
+
+        *count = data_size / element_size;
+        return true;
     }
 
-    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+    foxdbg_buffer_end_read(channel->data_buffer);
+    return false;
+}
 
-    
+/* one entity per channel, replaced on every message */
+static json channel_entity(foxdbg_channel_t *channel)
+{
+    json entity;
+    entity["frame_id"] = "world";
+    entity["id"] = channel->topic_name;
+    entity["timestamp"] = timestamp_object();
+
+    return entity;
+}
+
+static void send_entity(const json &entity, int subscription_id)
+{
     json j;
-    j["timestamp"]["sec"] = 0;
-    j["timestamp"]["nsec"] = 0;
-    
-    j["frame_id"] = "world";
-    
-    j["pose"]["position"] = {
-        {"x", 0.0},
-        {"y", 0.0},
-        {"z", 0.6}
-    };
-    
-    j["pose"]["orientation"] = {
-        {"x", 0.0},
-        {"y", 0.0},
-        {"z", 0.0},
-        {"w", 1.0}
-    };
-    
-    j["point_stride"] = sizeof(foxdbg_vector4_t);
-    
-    j["fields"] = {
-        {{"name", "x"}, {"offset", 0}, {"type", 7}},
-        {{"name", "y"}, {"offset", 4}, {"type", 7}},
-        {{"name", "z"}, {"offset", 8}, {"type", 7}},
-        {{"name", "intensity"}, {"offset", 12}, {"type", 7}}
-    };
-    
-    // Insert raw byte data into JSON array
-    j["data"] = std::vector<uint8_t>((uint8_t*)data, (uint8_t*)data + data_size);
+    j["entities"] = json::array({entity});
 
-    std::string jsonStr = j.dump();
+    /* text comes straight from the caller, do not throw on bad utf-8 */
+    std::string jsonStr = j.dump(-1, ' ', false, json::error_handler_t::replace);
 
     if (tx_buffer_size >= (jsonStr.size() + LWS_PRE + 13))
     {
@@ -764,15 +2994,19 @@ static void send_pointcloud(foxdbg_channel_t *channel)
             subscription_id
         );
     }
+    else
+    {
+        drop_payload(payload_channel, "Entity message too large for buffer");
+    }
 }
 
-static void send_cubes(foxdbg_channel_t *channel)
+static void send_scene(foxdbg_channel_t *channel)
 {
     void *data;
     size_t data_size;
-    foxdbg_buffer_begin_read(channel->data_buffer, &data, &data_size);
+    begin_payload(channel, &data, &data_size);
 
-    if (data_size <= sizeof(raw_data_buffer) && data_size > 0 && data_size % sizeof(foxdbg_cube_t) == 0)
+    if (data_size <= sizeof(raw_data_buffer) && data_size % sizeof(foxdbg_scene_entity_t) == 0)
     {
         memcpy(raw_data_buffer, data, data_size);
         foxdbg_buffer_end_read(channel->data_buffer);
@@ -785,250 +3019,365 @@ static void send_cubes(foxdbg_channel_t *channel)
 
     int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
 
-    json j;
-    j["entities"] = json::array();
+    scene_state_t *state = (scene_state_t *)channel->protocol_state;
 
-    json entity;
-    entity["frame_id"] = "world";
-    entity["id"] = channel->topic_name;
-    entity["timestamp"] = {
-        {"sec", 0},
-        {"nsec", 0}
-    };
+    if (!state)
+    {
+        state = new scene_state_t();
+        state->subscription_id = -1;
+        state->frame = 0;
+        channel->protocol_state = state;
+    }
 
-    size_t numCubes = data_size / sizeof(foxdbg_cube_t);
-    foxdbg_cube_t *cubes = (foxdbg_cube_t*)raw_data_buffer;
+    /* a new subscriber holds nothing yet, the recording only ever has the one */
+    int owner = payload_to_client ? subscription_id : -1;
 
-    for (size_t i = 0; i < numCubes; ++i)
+    if (state->subscription_id != owner)
     {
+        state->entities.clear();
+        state->subscription_id = owner;
+    }
 
-        foxdbg_cube_t cube = cubes[i];
-
-        json cube_object;
+    state->frame++;
 
-        cube_object["pose"]["position"] = {
-            {"x", cube.position.x},
-            {"y", cube.position.y},
-            {"z", cube.position.z}
-        };
+    uint64_t current_time = current_timestamp_ms();
 
-        float pitch = cube.orientation.x;
-        float roll = cube.orientation.y;
-        float yaw = cube.orientation.z + (float)M_PI/2.0f;  // <-- Adjust yaw by +90 degrees (important!)
-        
-        float cy = cos(yaw * 0.5f);
-        float sy = sin(yaw * 0.5f);
-        float cp = cos(pitch * 0.5f);
-        float sp = sin(pitch * 0.5f);
-        float cr = cos(roll * 0.5f);
-        float sr = sin(roll * 0.5f);
-        
-        // Standard XYZ euler to quaternion (for Foxglove arrow)
-        float qx = sr * cp * cy - cr * sp * sy;
-        float qy = cr * sp * cy + sr * cp * sy;
-        float qz = cr * cp * sy - sr * sp * cy;
-        float qw = cr * cp * cy + sr * sp * sy;    
-
-        cube_object["pose"]["orientation"] = {
-            {"x", qx},
-            {"y", qy},
-            {"z", qz},
-            {"w", qw}
-        };
-        
-        cube_object["size"] = {
-            {"x", cube.size.x},
-            {"y", cube.size.y},
-            {"z", cube.size.z}
-        };
+    size_t entity_count = data_size / sizeof(foxdbg_scene_entity_t);
+    foxdbg_scene_entity_t *entities = (foxdbg_scene_entity_t*)raw_data_buffer;
 
-        // Color mapping
-        foxdbg_color_t color = cube.color;
-        cube_object["color"] = {
-            {"r", color.r},
-            {"g", color.g},
-            {"b", color.b},
-            {"a", color.a}
-        };
+    std::string deletions;
+    std::vector<uint32_t> deleted;
+    std::vector<scene_update_t> changed;
 
-        entity["cubes"].push_back(cube_object);
+    if (payload_to_flight)
+    {
+        /* clear whatever an earlier message left behind, only entities at or before this go */
+        deletions = "{\"timestamp\":" + timestamp_object().dump() + ",\"type\":1,\"id\":\"\"}";
     }
 
-    j["entities"].push_back(entity);
+    for (size_t i = 0; i < entity_count; ++i)
+    {
+        const foxdbg_scene_entity_t *entity = &entities[i];
 
-    std::string jsonStr = j.dump();
+        size_t primitive_size = scene_primitive_size(entity->type);
+        if (primitive_size == 0)
+        {
+            continue; /* unknown primitive */
+        }
 
-    if (tx_buffer_size >= (jsonStr.size() + LWS_PRE + 13))
-    {
-        memcpy((uint8_t*)tx_buffer + LWS_PRE + 13, jsonStr.c_str(), jsonStr.size());
+        /* only the active union member, the rest may be uninitialised */
+        uint32_t lifetime_bits;
+        memcpy(&lifetime_bits, &entity->lifetime, sizeof(lifetime_bits));
 
-        send_buffer(
-            (uint8_t*)tx_buffer + LWS_PRE, 
-            tx_buffer_size, 
-            jsonStr.size() + 13,
-            subscription_id
-        );
-    }
-}
+        uint64_t hash = foxdbg_hash(&entity->primitive, primitive_size) ^
+            (((uint64_t)entity->type << 32) | lifetime_bits);
 
-static void send_lines(foxdbg_channel_t *channel)
-{
-    void *data;
-    size_t data_size;
-    foxdbg_buffer_begin_read(channel->data_buffer, &data, &data_size);
+        auto found = state->entities.find(entity->id);
 
-    if (data_size <= sizeof(raw_data_buffer) && data_size > 0 && data_size % sizeof(foxdbg_line_t) == 0)
-    {
-        memcpy(raw_data_buffer, data, data_size);
-        foxdbg_buffer_end_read(channel->data_buffer);
-    }
-    else 
-    {
-        foxdbg_buffer_end_read(channel->data_buffer);
-        return;
+        if (found != state->entities.end() && found->second.hash == hash)
+        {
+            const scene_entity_state_t &sent = found->second;
+
+            /* still being written, resend halfway through its lifetime so the client never lets it expire */
+            bool renew = sent.lifetime > 0 && (current_time - sent.changed_time) * 2 >= sent.lifetime;
+
+            if (!renew)
+            {
+                found->second.seen_frame = state->frame;
+                continue;
+            }
+        }
+
+        scene_update_t update;
+        update.id = entity->id;
+        update.state.hash = hash;
+        update.state.changed_time = current_time;
+        update.state.lifetime = entity->lifetime > 0.0f ? (uint64_t)(entity->lifetime * 1000.0f) : 0;
+        update.state.seen_frame = state->frame;
+        update.entity = scene_entity(entity).dump();
+
+        /* not deleted below, one never sent has hash 0 and goes again next frame */
+        state->entities[entity->id].seen_frame = state->frame;
+
+        changed.push_back(std::move(update));
     }
 
-    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+    for (auto it = state->entities.begin(); it != state->entities.end(); )
+    {
+        if (it->second.seen_frame == state->frame)
+        {
+            ++it;
+            continue;
+        }
 
-    json j;
-    j["entities"] = json::array();
+        bool expired = it->second.lifetime > 0 && (current_time - it->second.changed_time) >= it->second.lifetime;
 
-    json entity;
-    entity["frame_id"] = "world";
-    entity["id"] = channel->topic_name;
-    entity["timestamp"] = {
-        {"sec", 0},
-        {"nsec", 0}
-    };
+        if (!expired)
+        {
+            deletions += deletions.empty() ? "" : ",";
+            /* only entities stamped at or before this are deleted */
+            deletions += "{\"timestamp\":" + timestamp_object().dump() + ",\"type\":0,\"id\":\"" + std::to_string(it->first) + "\"}";
+
+            /* forgotten once the deletion is sent */
+            deleted.push_back(it->first);
+            ++it;
+            continue;
+        }
 
-    size_t numLines = data_size / sizeof(foxdbg_line_t);
-    foxdbg_line_t *lines = (foxdbg_line_t*)raw_data_buffer;
+        it = state->entities.erase(it);
+    }
 
-    for (size_t i = 0; i < numLines; ++i)
+    if (changed.empty() && deletions.empty())
     {
+        return;
+    }
 
-        foxdbg_line_t line = lines[i];
+    /* split into as many updates as it takes to fit the tx buffer */
+    std::string message = "{\"deletions\":[" + deletions + "],\"entities\":[";
+    bool first = true;
 
-        json line_object;
+    size_t capacity = tx_buffer_size - LWS_PRE - 13 - 2;
 
-        line_object["type"] = 2; /* LINE_LIST */
+    /* changed[first_update..end) are in the message, the deletions only in the first one */
+    size_t first_update = 0;
 
-        line_object["pose"]["position"] = {
-            {"x", 0.0f}, {"y", 0.0f}, {"z", 0.0f}
-        };
+    auto flush = [&](size_t end) {
+        if (!flush_scene_update(message, subscription_id))
+        {
+            return;
+        }
 
-        line_object["pose"]["orientation"] = {
-            {"x", 0.0f}, {"y", 0.0f}, {"z", 0.0f}, {"w", 1.0f}
-        };
+        for (size_t i = first_update; i < end; ++i)
+        {
+            state->entities[changed[i].id] = changed[i].state;
+        }
 
-        line_object["thickness"] = line.thickness;
-        line_object["scale_invariant"] = false;
-        line_object["points"] = json::array();
-        line_object["points"].push_back({
-            {"x", line.start.x},
-            {"y", line.start.y},
-            {"z", line.start.z}
-        });
-        line_object["points"].push_back({
-            {"x", line.end.x},
-            {"y", line.end.y},
-            {"z", line.end.z}
-        });
+        if (first_update == 0)
+        {
+            for (uint32_t id : deleted)
+            {
+                state->entities.erase(id);
+            }
+        }
+    };
 
-        // Color mapping
-        foxdbg_color_t color = line.color;
-        line_object["color"] = {
-            {"r", color.r},
-            {"g", color.g},
-            {"b", color.b},
-            {"a", color.a}
-        };
+    for (size_t i = 0; i < changed.size(); ++i)
+    {
+        const std::string &entity = changed[i].entity;
+
+        if (!first && message.size() + 1 + entity.size() > capacity)
+        {
+            flush(i);
 
-        entity["lines"].push_back(line_object);
+            message = "{\"deletions\":[],\"entities\":[";
+            first = true;
+            first_update = i;
+        }
+
+        if (!first)
+        {
+            message += ',';
+        }
 
+        message += entity;
+        first = false;
     }
 
-    j["entities"].push_back(entity);
+    flush(changed.size());
+}
 
-    std::string jsonStr = j.dump();
+static bool flush_scene_update(std::string &message, int subscription_id)
+{
+    message += "]}";
 
-    if (tx_buffer_size >= (jsonStr.size() + LWS_PRE + 13))
+    if (tx_buffer_size >= (message.size() + LWS_PRE + 13))
     {
-        memcpy((uint8_t*)tx_buffer + LWS_PRE + 13, jsonStr.c_str(), jsonStr.size());
+        memcpy((uint8_t*)tx_buffer + LWS_PRE + 13, message.c_str(), message.size());
 
-        send_buffer(
+        return send_buffer(
             (uint8_t*)tx_buffer + LWS_PRE, 
             tx_buffer_size, 
-            jsonStr.size() + 13,
+            message.size() + 13,
             subscription_id
         );
     }
+
+    drop_payload(payload_channel, "Scene entity too large for buffer");
+    return false;
 }
 
-static void send_pose(foxdbg_channel_t *channel)
+static size_t scene_primitive_size(foxdbg_scene_primitive_t type)
 {
-    void *data;
-    size_t data_size;
-    foxdbg_buffer_begin_read(channel->data_buffer, &data, &data_size);
-
-    if (data_size <= sizeof(raw_data_buffer) && data_size == sizeof(foxdbg_pose_t))
+    switch (type)
     {
-        memcpy(raw_data_buffer, data, data_size);
-        foxdbg_buffer_end_read(channel->data_buffer);
+        case FOXDBG_SCENE_PRIMITIVE_CUBE:  return sizeof(foxdbg_cube_t);
+        case FOXDBG_SCENE_PRIMITIVE_LINE:  return sizeof(foxdbg_line_t);
+        case FOXDBG_SCENE_PRIMITIVE_ARROW: return sizeof(foxdbg_pose_t);
+        default:                           return 0;
     }
-    else 
+}
+
+static json scene_entity(const foxdbg_scene_entity_t *scene_entity)
+{
+    json entity;
+    entity["frame_id"] = "world";
+    entity["id"] = std::to_string(scene_entity->id);
+    entity["timestamp"] = timestamp_object();
+
+    uint64_t lifetime_ns = scene_entity->lifetime > 0.0f ? (uint64_t)((double)scene_entity->lifetime * 1e9) : 0;
+    entity["lifetime"] = {
+        {"sec", lifetime_ns / 1000000000ULL},
+        {"nsec", lifetime_ns % 1000000000ULL}
+    };
+    entity["frame_locked"] = false;
+
+    switch (scene_entity->type)
     {
-        foxdbg_buffer_end_read(channel->data_buffer);
-        return;
+        case FOXDBG_SCENE_PRIMITIVE_CUBE:
+        {
+            foxdbg_vector4_t orientation;
+            foxdbg_math_euler_to_quaternion(&scene_entity->primitive.cube.orientation, sizeof(foxdbg_cube_t), FOXDBG_MARKER_YAW_OFFSET, &orientation, 1);
+
+            entity["cubes"] = json::array({cube_object(&scene_entity->primitive.cube, &orientation)});
+        } break;
+
+        case FOXDBG_SCENE_PRIMITIVE_LINE:
+        {
+            entity["lines"] = line_list_objects(&scene_entity->primitive.line, 1);
+        } break;
+
+        case FOXDBG_SCENE_PRIMITIVE_ARROW:
+        {
+            foxdbg_vector4_t orientation;
+            foxdbg_math_euler_to_quaternion(&scene_entity->primitive.arrow.orientation, sizeof(foxdbg_pose_t), FOXDBG_MARKER_YAW_OFFSET, &orientation, 1);
+
+            entity["arrows"] = json::array({arrow_object(&scene_entity->primitive.arrow, &orientation)});
+        } break;
+
+        default:
+        {
+
+        } break;
     }
 
-    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+    return entity;
+}
 
-    json j;
-    j["entities"] = json::array();
+static json cube_object(const foxdbg_cube_t *cube, const foxdbg_vector4_t *orientation)
+{
+    json cube_object;
 
-    json entity;
-    entity["frame_id"] = "world";
-    entity["id"] = channel->topic_name;
-    entity["timestamp"] = {
-        {"sec", 0},
-        {"nsec", 0}
+    cube_object["pose"]["position"] = {
+        {"x", cube->position.x},
+        {"y", cube->position.y},
+        {"z", cube->position.z}
     };
 
-    entity["arrows"] = json::array();
+    cube_object["pose"]["orientation"] = quaternion_object(orientation);
     
-    foxdbg_pose_t pose = *(foxdbg_pose_t*)raw_data_buffer;
+    cube_object["size"] = {
+        {"x", cube->size.x},
+        {"y", cube->size.y},
+        {"z", cube->size.z}
+    };
+
+    // Color mapping
+    foxdbg_color_t color = cube->color;
+    cube_object["color"] = {
+        {"r", color.r},
+        {"g", color.g},
+        {"b", color.b},
+        {"a", color.a}
+    };
+
+    return cube_object;
+}
+
+static json line_list_objects(const foxdbg_line_t *lines, size_t count)
+{
+    json line_lists = json::array();
+
+    /* one LINE_LIST per distinct thickness, in order of first use */
+    std::unordered_map<uint32_t, size_t> thickness_index;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const foxdbg_line_t *line = &lines[i];
+
+        uint32_t thickness_bits;
+        memcpy(&thickness_bits, &line->thickness, sizeof(thickness_bits));
+
+        auto found = thickness_index.find(thickness_bits);
+
+        if (found == thickness_index.end())
+        {
+            json line_list;
+
+            line_list["type"] = 2; /* LINE_LIST */
+
+            line_list["pose"]["position"] = {
+                {"x", 0.0f}, {"y", 0.0f}, {"z", 0.0f}
+            };
+
+            line_list["pose"]["orientation"] = {
+                {"x", 0.0f}, {"y", 0.0f}, {"z", 0.0f}, {"w", 1.0f}
+            };
+
+            line_list["thickness"] = line->thickness;
+            line_list["scale_invariant"] = false;
+            line_list["points"] = json::array();
+            line_list["colors"] = json::array();
+
+            /* unused while colors is set, but required by the schema */
+            line_list["color"] = {
+                {"r", line->color.r},
+                {"g", line->color.g},
+                {"b", line->color.b},
+                {"a", line->color.a}
+            };
+
+            found = thickness_index.emplace(thickness_bits, line_lists.size()).first;
+            line_lists.push_back(std::move(line_list));
+        }
+
+        json &points = line_lists[found->second]["points"];
+        json &colors = line_lists[found->second]["colors"];
+
+        points.push_back({
+            {"x", line->start.x},
+            {"y", line->start.y},
+            {"z", line->start.z}
+        });
+        points.push_back({
+            {"x", line->end.x},
+            {"y", line->end.y},
+            {"z", line->end.z}
+        });
+
+        json color = {
+            {"r", line->color.r},
+            {"g", line->color.g},
+            {"b", line->color.b},
+            {"a", line->color.a}
+        };
 
-    float pitch = pose.orientation.x;
-    float roll = pose.orientation.y;
-    float yaw = pose.orientation.z + (float)M_PI/2.0f;  // <-- Adjust yaw by +90 degrees (important!)
-    
-    float cy = cos(yaw * 0.5f);
-    float sy = sin(yaw * 0.5f);
-    float cp = cos(pitch * 0.5f);
-    float sp = sin(pitch * 0.5f);
-    float cr = cos(roll * 0.5f);
-    float sr = sin(roll * 0.5f);
-    
-    // Standard XYZ euler to quaternion (for Foxglove arrow)
-    float qx = sr * cp * cy - cr * sp * sy;
-    float qy = cr * sp * cy + sr * cp * sy;
-    float qz = cr * cp * sy - sr * sp * cy;
-    float qw = cr * cp * cy + sr * sp * sy;    
+        colors.push_back(color);
+        colors.push_back(std::move(color));
+    }
+
+    return line_lists;
+}
 
+static json arrow_object(const foxdbg_pose_t *pose, const foxdbg_vector4_t *orientation)
+{
     json arrow_object;
     arrow_object["pose"]["position"] = {
-        {"x", pose.position.x},
-        {"y", pose.position.y},
-        {"z", pose.position.z}
+        {"x", pose->position.x},
+        {"y", pose->position.y},
+        {"z", pose->position.z}
     };
 
-    arrow_object["pose"]["orientation"] = {
-        {"x", qx},
-        {"y", qy},
-        {"z", qz},
-        {"w", qw}
-    };
+    arrow_object["pose"]["orientation"] = quaternion_object(orientation);
     
     arrow_object["shaft_length"] = 0.5f;
     arrow_object["shaft_diameter"] = 0.05f;
@@ -1036,7 +3385,7 @@ static void send_pose(foxdbg_channel_t *channel)
     arrow_object["head_diameter"] = 0.1f;
 
     // Color mapping
-    foxdbg_color_t color = pose.color;
+    foxdbg_color_t color = pose->color;
     arrow_object["color"] = {
         {"r", color.r},
         {"g", color.g},
@@ -1044,288 +3393,293 @@ static void send_pose(foxdbg_channel_t *channel)
         {"a", color.a}
     };
 
-    entity["arrows"].push_back(arrow_object);
-
-    j["entities"].push_back(entity);
-
-    std::string jsonStr = j.dump();
-
-    if (tx_buffer_size >= (jsonStr.size() + LWS_PRE + 13))
-    {
-        memcpy((uint8_t*)tx_buffer + LWS_PRE + 13, jsonStr.c_str(), jsonStr.size());
-
-        send_buffer(
-            (uint8_t*)tx_buffer + LWS_PRE, 
-            tx_buffer_size, 
-            jsonStr.size() + 13,
-            subscription_id
-        );
-    }
+    return arrow_object;
 }
 
-static void send_transform(foxdbg_channel_t *channel)
+static json sphere_object(const foxdbg_sphere_t *sphere)
 {
+    json sphere_object;
 
-    float *data;
-    size_t data_size;
-    foxdbg_buffer_begin_read(channel->data_buffer, (void**)&data, &data_size);
+    sphere_object["pose"]["position"] = {
+        {"x", sphere->position.x},
+        {"y", sphere->position.y},
+        {"z", sphere->position.z}
+    };
 
-    if (data_size <= sizeof(raw_data_buffer) && data_size == sizeof(foxdbg_transform_t))
-    {
-        memcpy(raw_data_buffer, data, data_size);
-        foxdbg_buffer_end_read(channel->data_buffer);
-    }
-    else 
-    {
-        foxdbg_buffer_end_read(channel->data_buffer);
-        return;
-    }
+    sphere_object["pose"]["orientation"] = {
+        {"x", 0.0f}, {"y", 0.0f}, {"z", 0.0f}, {"w", 1.0f}
+    };
 
-    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+    sphere_object["size"] = {
+        {"x", sphere->size.x},
+        {"y", sphere->size.y},
+        {"z", sphere->size.z}
+    };
 
+    sphere_object["color"] = color_object(&sphere->color);
 
-    foxdbg_transform_t *transform = (foxdbg_transform_t*)raw_data_buffer;
+    return sphere_object;
+}
 
-    json json_data;
-    json_data["timestamp"]["sec"] = 0;
-    json_data["timestamp"]["nsec"] = 0;
+static json arrow_array_object(const foxdbg_arrow_t *arrow, const foxdbg_vector4_t *orientation)
+{
+    json arrow_object;
+    arrow_object["pose"]["position"] = {
+        {"x", arrow->position.x},
+        {"y", arrow->position.y},
+        {"z", arrow->position.z}
+    };
 
-    json_data["parent_frame_id"] = transform->parent_id;
-    json_data["child_frame_id"] = transform->id;
+    arrow_object["pose"]["orientation"] = quaternion_object(orientation);
 
-    json_data["translation"] = {
-        {"x", transform->position.x},
-        {"y", transform->position.y},
-        {"z", transform->position.z}
-    };
+    /* head takes the last quarter, same proportions as the pose arrow */
+    arrow_object["shaft_length"] = arrow->length * 0.75f;
+    arrow_object["shaft_diameter"] = arrow->diameter;
+    arrow_object["head_length"] = arrow->length * 0.25f;
+    arrow_object["head_diameter"] = arrow->diameter * 2.0f;
 
-    float pitch = transform->orientation.x;
-    float roll = transform->orientation.y;
-    float yaw = transform->orientation.z;
+    arrow_object["color"] = color_object(&arrow->color);
 
-    float cy = cos(yaw * 0.5f);
-    float sy = sin(yaw * 0.5f);
-    float cp = cos(pitch * 0.5f);
-    float sp = sin(pitch * 0.5f);
-    float cr = cos(roll * 0.5f);
-    float sr = sin(roll * 0.5f);
+    return arrow_object;
+}
 
-    // Standard XYZ euler to quaternion (for Foxglove arrow)
-    float qx = sr * cp * cy - cr * sp * sy;
-    float qy = cr * sp * cy + sr * cp * sy;
-    float qz = cr * cp * sy - sr * sp * cy;
-    float qw = cr * cp * cy + sr * sp * sy;    
+static json triangle_list_object(const foxdbg_triangle_t *triangles, size_t count)
+{
+    json triangle_list;
 
-    json_data["rotation"] = {
-        {"x", qx},
-        {"y", qy},
-        {"z", qz},
-        {"w", qw}
+    triangle_list["pose"]["position"] = {
+        {"x", 0.0f}, {"y", 0.0f}, {"z", 0.0f}
     };
 
-    std::string json_str = json_data.dump();
-    size_t json_len = json_str.length();
+    triangle_list["pose"]["orientation"] = {
+        {"x", 0.0f}, {"y", 0.0f}, {"z", 0.0f}, {"w", 1.0f}
+    };
 
-    if (json_len + LWS_PRE + 13 < sizeof(tx_buffer))
+    json points = json::array();
+    json colors = json::array();
+
+    for (size_t i = 0; i < count; ++i)
     {
-        memcpy(tx_buffer + LWS_PRE + 13, json_str.c_str(), json_len);
+        for (size_t v = 0; v < 3; ++v)
+        {
+            points.push_back({
+                {"x", triangles[i].vertices[v].x},
+                {"y", triangles[i].vertices[v].y},
+                {"z", triangles[i].vertices[v].z}
+            });
 
-        send_buffer(
-            (uint8_t*)tx_buffer + LWS_PRE, 
-            tx_buffer_size, 
-            json_len + 13,
-            subscription_id
-        );
+            colors.push_back(color_object(&triangles[i].colors[v]));
+        }
     }
+
+    /* unused while colors is set, but required by the schema */
+    triangle_list["color"] = colors[0];
+    triangle_list["points"] = std::move(points);
+    triangle_list["colors"] = std::move(colors);
+    triangle_list["indices"] = json::array();
+
+    return triangle_list;
 }
 
-static void send_location(foxdbg_channel_t *channel)
+static json text_object(const foxdbg_text_t *text)
 {
-    void *data;
-    size_t data_size;
-    foxdbg_buffer_begin_read(channel->data_buffer, &data, &data_size);
+    json text_object;
 
-    if (data_size <= sizeof(raw_data_buffer) && data_size == sizeof(foxdbg_location_t))
-    {
-        memcpy(raw_data_buffer, data, data_size);
-        foxdbg_buffer_end_read(channel->data_buffer);
-    }
-    else 
-    {
-        foxdbg_buffer_end_read(channel->data_buffer);
-        return;
-    }
+    text_object["pose"]["position"] = {
+        {"x", text->position.x},
+        {"y", text->position.y},
+        {"z", text->position.z}
+    };
 
-    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+    text_object["pose"]["orientation"] = {
+        {"x", 0.0f}, {"y", 0.0f}, {"z", 0.0f}, {"w", 1.0f}
+    };
 
-    foxdbg_location_t *location = (foxdbg_location_t*)raw_data_buffer;
+    text_object["billboard"] = true;
+    text_object["font_size"] = text->font_size;
+    text_object["scale_invariant"] = true;
+    text_object["color"] = color_object(&text->color);
+    text_object["text"] = std::string(text->text, strnlen(text->text, FOXDBG_TEXT_LENGTH));
 
-    json json_data = {
-        {"timestamp", {
-            {"sec", location->timestamp_sec},
-            {"nsec", location->timestamp_nsec}
-        }},
-        {"frame_id", "world"},
-        {"latitude", location->latitude},
-        {"longitude", location->longitude},
-        {"altitude", location->altitude}
-    };
+    return text_object;
+}
 
-    json_data["position_covariance"] = std::vector<double>(9, 0.0);
-    json_data["position_covariance_type"] = 0;
+static json frame_transform_object(const foxdbg_frame_transform_t *transform, const foxdbg_vector4_t *rotation)
+{
+    json frame_transform;
+    frame_transform["timestamp"] = timestamp_object();
 
-    std::string json_str = json_data.dump();
-    size_t json_len = json_str.length();
+    frame_transform["parent_frame_id"] = foxdbg_frames_name(transform->parent);
+    frame_transform["child_frame_id"] = foxdbg_frames_name(transform->frame);
 
-    if (json_len + LWS_PRE + 13 < sizeof(tx_buffer))
-    {
-        memcpy(tx_buffer + LWS_PRE + 13, json_str.c_str(), json_len);
+    frame_transform["translation"] = {
+        {"x", transform->position.x},
+        {"y", transform->position.y},
+        {"z", transform->position.z}
+    };
 
-        send_buffer(
-            (uint8_t*)tx_buffer + LWS_PRE, 
-            tx_buffer_size, 
-            json_len + 13,
-            subscription_id
-        );
-    }
+    frame_transform["rotation"] = quaternion_object(rotation);
+
+    return frame_transform;
 }
 
-static void send_float(foxdbg_channel_t *channel)
+static bool transform_moved(foxdbg_channel_t *channel, const sent_transform_t *sent, const foxdbg_frame_transform_t *transform, const foxdbg_vector4_t *rotation)
 {
-
-    void *data;
-    size_t data_size;
-    foxdbg_buffer_begin_read(channel->data_buffer, (void**)&data, &data_size);
-
-    if (data_size <= sizeof(raw_data_buffer) && data_size == sizeof(float))
+    if (memcmp(&sent->position, &transform->position, sizeof(foxdbg_vector3_t)) == 0 &&
+        memcmp(&sent->rotation, rotation, sizeof(foxdbg_vector4_t)) == 0)
     {
-        memcpy(raw_data_buffer, data, data_size);
-        foxdbg_buffer_end_read(channel->data_buffer);
+        return false;
     }
-    else 
+
+    float dx = transform->position.x - sent->position.x;
+    float dy = transform->position.y - sent->position.y;
+    float dz = transform->position.z - sent->position.z;
+
+    if (dx * dx + dy * dy + dz * dz > channel->transform_distance * channel->transform_distance)
     {
-        foxdbg_buffer_end_read(channel->data_buffer);
-        return;
+        return true;
     }
 
-    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+    /* angle between unit quaternions is 2 acos |q1 . q2| */
+    float dot = fabsf(
+        sent->rotation.x * rotation->x + sent->rotation.y * rotation->y +
+        sent->rotation.z * rotation->z + sent->rotation.w * rotation->w
+    );
 
-    float *raw = (float*)raw_data_buffer;
+    return 2.0f * acosf(fminf(dot, 1.0f)) > channel->transform_angle;
+}
 
-    json json_data = {
-        {"value", (*raw)}
+static json timestamp_object(void)
+{
+    return {
+        {"sec", payload_timestamp / 1000000000ULL},
+        {"nsec", payload_timestamp % 1000000000ULL}
     };
+}
 
-    std::string json_str = json_data.dump();
-    size_t json_len = json_str.length();
-
-    if (json_len + LWS_PRE + 13 < sizeof(tx_buffer))
-    {
-        memcpy(tx_buffer + LWS_PRE + 13, json_str.c_str(), json_len);
-
-        send_buffer(
-            (uint8_t*)tx_buffer + LWS_PRE, 
-            tx_buffer_size, 
-            json_len + 13,
-            subscription_id
-        );
-    }
-    
+static void record_latency(foxdbg_channel_t *channel, uint64_t write_time, uint64_t now)
+{
+    record_duration(&channel->latency, now > write_time ? now - write_time : 0);
 }
 
-static void send_integer(foxdbg_channel_t *channel)
+/* add to a log2 histogram of microseconds, see FOXDBG_LATENCY_BUCKETS */
+static void record_duration(foxdbg_latency_t *latency, uint64_t duration_ns)
 {
-    void *data;
-    size_t data_size;
-    foxdbg_buffer_begin_read(channel->data_buffer, (void**)&data, &data_size);
+    uint64_t latency_us = duration_ns / 1000ULL;
 
-    if (data_size <= sizeof(raw_data_buffer) && data_size == sizeof(int))
+    size_t bucket = 0;
+    while (bucket + 1 < FOXDBG_LATENCY_BUCKETS && (latency_us >> (bucket + 1)) != 0)
     {
-        memcpy(raw_data_buffer, data, data_size);
-        foxdbg_buffer_end_read(channel->data_buffer);
+        bucket++;
     }
-    else 
+
+    latency->count++;
+    latency->total_us += latency_us;
+    latency->buckets[bucket]++;
+
+    if (latency_us > latency->max_us)
     {
-        foxdbg_buffer_end_read(channel->data_buffer);
-        return;
+        latency->max_us = latency_us;
     }
+}
 
-    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
+/* mean and percentiles of the durations added since last */
+static json duration_object(const foxdbg_latency_t *latency, const foxdbg_latency_t *last)
+{
+    uint64_t count = latency->count - last->count;
+    uint64_t total_us = latency->total_us - last->total_us;
+
+    return {
+        {"count", count},
+        {"mean", count ? (double)total_us / (double)count : 0.0},
+        {"p50", bucket_percentile(latency, last, 0.50)},
+        {"p90", bucket_percentile(latency, last, 0.90)},
+        {"p99", bucket_percentile(latency, last, 0.99)}
+    };
+}
 
-    int *raw = (int*)raw_data_buffer;
+/* upper bound of the bucket holding the p quantile, 0 if nothing was added */
+static uint64_t bucket_percentile(const foxdbg_latency_t *latency, const foxdbg_latency_t *last, double p)
+{
+    uint64_t count = latency->count - last->count;
 
-    json json_data = {
-        {"value", (*raw)}
-    };
+    if (count == 0)
+    {
+        return 0;
+    }
 
-    std::string json_str = json_data.dump();
-    size_t json_len = json_str.length();
+    uint64_t rank = (uint64_t)ceil(p * (double)count);
+    uint64_t seen = 0;
 
-    if (json_len + LWS_PRE + 13 < sizeof(tx_buffer))
+    for (size_t bucket = 0; bucket < FOXDBG_LATENCY_BUCKETS; bucket++)
     {
-        memcpy(tx_buffer + LWS_PRE + 13, json_str.c_str(), json_len);
+        seen += latency->buckets[bucket] - last->buckets[bucket];
 
-        send_buffer(
-            (uint8_t*)tx_buffer + LWS_PRE, 
-            tx_buffer_size, 
-            json_len + 13,
-            subscription_id
-        );
+        if (seen >= rank)
+        {
+            return 2ULL << bucket;
+        }
     }
-}
 
+    return 2ULL << (FOXDBG_LATENCY_BUCKETS - 1);
+}
 
-static void send_bool(foxdbg_channel_t *channel)
+/* bytes the kernel has yet to send to the client, only known on Linux */
+static uint64_t socket_queued_bytes(void)
 {
-    void *data;
-    size_t data_size;
-    foxdbg_buffer_begin_read(channel->data_buffer, (void**)&data, &data_size);
+#if defined(__linux__)
+    int queued = 0;
 
-    if (data_size <= sizeof(raw_data_buffer) && data_size == sizeof(bool))
-    {
-        memcpy(raw_data_buffer, data, data_size);
-        foxdbg_buffer_end_read(channel->data_buffer);
-    }
-    else 
+    if (client && ioctl(lws_get_socket_fd(client), SIOCOUTQ, &queued) == 0 && queued > 0)
     {
-        foxdbg_buffer_end_read(channel->data_buffer);
-        return;
+        return (uint64_t)queued;
     }
+#endif
 
-    int subscription_id = ATOMIC_READ_INT(&channel->subscription_id);
-
-    bool *raw = (bool*)raw_data_buffer;
+    return 0;
+}
 
-    json json_data = {
-        {"value", (*raw)}
-    };
+/* a payload that was encoded but could not be sent, counted for FOXDBG_STATS_TOPIC */
+static void drop_payload(foxdbg_channel_t *channel, const char *reason)
+{
+    fprintf(stderr, "%s\n", reason);
 
-    std::string json_str = json_data.dump();
-    size_t json_len = json_str.length();
+    payload_delivered = false;
 
-    if (json_len + LWS_PRE + 13 < sizeof(tx_buffer))
+    if (channel)
     {
-        memcpy(tx_buffer + LWS_PRE + 13, json_str.c_str(), json_len);
+        channel->send_dropped++;
 
-        send_buffer(
-            (uint8_t*)tx_buffer + LWS_PRE, 
-            tx_buffer_size, 
-            json_len + 13,
-            subscription_id
-        );
+        /* an earlier part may have been recorded as sent, the whole payload goes again */
+        channel->last_sent_subscription_id = -1;
     }
 }
 
+static json color_object(const foxdbg_color_t *color)
+{
+    return {
+        {"r", color->r},
+        {"g", color->g},
+        {"b", color->b},
+        {"a", color->a}
+    };
+}
+
+static json quaternion_object(const foxdbg_vector4_t *q)
+{
+    return {
+        {"x", q->x},
+        {"y", q->y},
+        {"z", q->z},
+        {"w", q->w}
+    };
+}
 
-static size_t encode_image_byte_array(uint8_t* tx_buffer, size_t tx_buffer_size, int width, int height, int components, const uint8_t* compressedImage, size_t compressedSize) {
+static size_t encode_image_byte_array(uint8_t* tx_buffer, size_t tx_buffer_size, int width, int height, int components, const char *encoding, const uint8_t* compressedImage, size_t compressedSize) {
 
-    /* Estimate required buffer size (same as before) */
-    size_t estimated_json_overhead = 100; /* A safe estimate */
-    size_t estimated_data_size = compressedSize * 4; /* Max 3 digits + comma per byte */
-    size_t estimated_total_size = estimated_json_overhead + estimated_data_size + 10;
+    size_t json_overhead = 224; /* fixed fields plus closing brackets */
 
-    if (estimated_total_size > tx_buffer_size) {
-        fprintf(stderr, "Estimated JSON message too large for buffer\n");
+    if (tx_buffer_size < json_overhead) {
         return 0; // Indicate failure
     }
 
@@ -1333,15 +3687,57 @@ static size_t encode_image_byte_array(uint8_t* tx_buffer, size_t tx_buffer_size,
     size_t bytes_written = 0;
 
     /* Write the fixed JSON parts */
-    bytes_written += sprintf(buffer_ptr + bytes_written, "{\"width\":%d,", width);
+    bytes_written += sprintf(buffer_ptr + bytes_written, "{\"timestamp\":{\"sec\":%llu,\"nsec\":%llu},",
+        (unsigned long long)(payload_timestamp / 1000000000ULL), (unsigned long long)(payload_timestamp % 1000000000ULL));
+    bytes_written += sprintf(buffer_ptr + bytes_written, "\"width\":%d,", width);
     bytes_written += sprintf(buffer_ptr + bytes_written, "\"height\":%d,", height);
     bytes_written += sprintf(buffer_ptr + bytes_written, "\"channels\":%d,", components);
-    bytes_written += sprintf(buffer_ptr + bytes_written, "\"encoding\":\"jpeg\",");
-    bytes_written += sprintf(buffer_ptr + bytes_written, "\"data\":[");
+    bytes_written += sprintf(buffer_ptr + bytes_written, "\"encoding\":\"%s\",", encoding);
+    bytes_written += sprintf(buffer_ptr + bytes_written, "\"data\":");
+
+    size_t array_size = encode_byte_array(
+        tx_buffer + bytes_written,
+        tx_buffer_size - bytes_written - 2,
+        compressedImage, compressedSize
+    );
+
+    if (array_size == 0) {
+        drop_payload(payload_channel, "Image message too large for buffer");
+        return 0; // Indicate failure
+    }
+
+    bytes_written += array_size;
+
+    /* Close the JSON object */
+    buffer_ptr[bytes_written++] = '}';
+    buffer_ptr[bytes_written] = '\0'; /* Null terminate */
+
+    return bytes_written; /* Return the actual size of the JSON data */
+}
+
+static size_t encode_byte_array(uint8_t* buffer, size_t buffer_size, const uint8_t* data, size_t data_size) {
+
+    size_t max_array_size = data_size * 4 + 2; /* Max 3 digits + comma per byte, plus brackets */
+
+    /* only check per byte when the worst case might not fit */
+    bool checked = max_array_size > buffer_size;
+
+    if (buffer_size < 2) {
+        return 0;
+    }
+
+    char* buffer_ptr = (char*)buffer;
+    size_t bytes_written = 0;
+
+    buffer_ptr[bytes_written++] = '[';
 
     /* Write the byte array with manual conversion and fewer calls */
-    for (size_t i = 0; i < compressedSize; ++i) {
-        uint8_t byte = compressedImage[i];
+    for (size_t i = 0; i < data_size; ++i) {
+        if (checked && bytes_written + 5 > buffer_size) {
+            return 0; // Indicate failure
+        }
+
+        uint8_t byte = data[i];
         if (byte >= 100) {
             buffer_ptr[bytes_written++] = '0' + (byte / 100);
             buffer_ptr[bytes_written++] = '0' + ((byte / 10) % 10);
@@ -1353,15 +3749,12 @@ static size_t encode_image_byte_array(uint8_t* tx_buffer, size_t tx_buffer_size,
             buffer_ptr[bytes_written++] = '0' + byte;
         }
 
-        if (i < compressedSize - 1) {
+        if (i < data_size - 1) {
             buffer_ptr[bytes_written++] = ',';
         }
     }
 
-    /* Close the data array and the JSON object */
     buffer_ptr[bytes_written++] = ']';
-    buffer_ptr[bytes_written++] = '}';
-    buffer_ptr[bytes_written] = '\0'; /* Null terminate */
 
-    return bytes_written; /* Return the actual size of the JSON data */
+    return bytes_written;
 }
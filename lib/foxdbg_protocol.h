@@ -44,7 +44,7 @@
 extern "C" {
 #endif
 
-void foxdbg_protocol_init(lws_context *context, foxdbg_channel_t **channels, size_t *channel_count);
+void foxdbg_protocol_init(lws_context *context, foxdbg_channel_t **channels, size_t *channel_count, foxdbg_channel_t **rx_channels, size_t *rx_channel_count);
 
 void foxdbg_protocol_shutdown(void);
 
@@ -54,7 +54,16 @@ void foxdbg_protocol_disconnect(lws *client);
 
 void foxdbg_protocol_transmit_subscriptions(void);
 
-void foxdbg_protocol_receive(char* data, size_t len);
+bool foxdbg_protocol_has_client(void);
+
+/* true while the recorder or a flight ring wants every payload */
+bool foxdbg_protocol_is_recording(void);
+
+/* build the messages for a channel's latest payload as for a client, without sending them. returns their size */
+size_t foxdbg_protocol_encode(foxdbg_channel_t *channel);
+
+/* final is false while lws is still delivering parts of the message */
+void foxdbg_protocol_receive(const char *data, size_t len, bool final);
 
 #ifdef __cplusplus
 }
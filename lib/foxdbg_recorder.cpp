@@ -0,0 +1,197 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_recorder.cpp
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server MCAP Recorder
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_recorder.h"
+#include "foxdbg_mcap.h"
+
+#include <stdio.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+typedef struct
+{
+    int channel_id;
+    const char *topic;
+    const char *schema_name;
+    const char *schema;
+    uint64_t log_time;
+    uint64_t publish_time;
+    std::vector<uint8_t> data;
+} queued_message_t;
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+static void recorder_thread_main(void);
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+static std::atomic_bool active(false);
+static std::thread recorder_thread;
+
+/* owned by the I/O thread while recording */
+static foxdbg_mcap_writer_t *writer = NULL;
+
+/* handed from the server thread to the I/O thread under queue_mutex */
+static std::mutex queue_mutex;
+static std::condition_variable queue_ready;
+static std::deque<queued_message_t> queue;
+static size_t queue_bytes = 0;
+static bool stopping = false;
+static uint64_t dropped = 0;
+
+static uint64_t message_count = 0;
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+bool foxdbg_recorder_open(const char *path)
+{
+    if (active.load() || recorder_thread.joinable())
+    {
+        return false;
+    }
+
+    writer = foxdbg_mcap_writer_open(path);
+
+    if (!writer)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        queue.clear();
+        queue_bytes = 0;
+        stopping = false;
+        dropped = 0;
+    }
+
+    recorder_thread = std::thread(recorder_thread_main);
+    active.store(true);
+
+    printf("FOXDBG: Recording to %s\n", path);
+
+    return true;
+}
+
+void foxdbg_recorder_close(void)
+{
+    if (!recorder_thread.joinable())
+    {
+        return;
+    }
+
+    active.store(false);
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+
+    queue_ready.notify_one();
+    recorder_thread.join();
+
+    printf("FOXDBG: Recording closed, %llu messages, %llu dropped\n",
+        (unsigned long long)message_count, (unsigned long long)dropped);
+}
+
+bool foxdbg_recorder_active(void)
+{
+    return active.load();
+}
+
+void foxdbg_recorder_write(
+    int channel_id, const char *topic, const char *schema_name, const char *schema,
+    uint64_t log_time, uint64_t publish_time,
+    const uint8_t *data, size_t size)
+{
+    if (!active.load())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(queue_mutex);
+
+    if (stopping || queue_bytes + size > FOXDBG_RECORDER_QUEUE_SIZE)
+    {
+        dropped++; /* the disk is not keeping up */
+        return;
+    }
+
+    queue.push_back({ channel_id, topic, schema_name, schema, log_time, publish_time, std::vector<uint8_t>(data, data + size) });
+    queue_bytes += size;
+
+    queue_ready.notify_one();
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
+
+static void recorder_thread_main(void)
+{
+    std::deque<queued_message_t> batch;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_ready.wait(lock, [] { return !queue.empty() || stopping; });
+
+            if (queue.empty() && stopping)
+            {
+                break;
+            }
+
+            batch.swap(queue);
+            queue_bytes = 0;
+        }
+
+        for (const queued_message_t &message : batch)
+        {
+            foxdbg_mcap_writer_write(
+                writer,
+                message.channel_id, message.topic, message.schema_name, message.schema,
+                message.log_time, message.publish_time,
+                message.data.data(), message.data.size()
+            );
+        }
+
+        batch.clear();
+    }
+
+    message_count = foxdbg_mcap_writer_close(writer);
+    writer = NULL;
+}
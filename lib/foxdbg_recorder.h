@@ -0,0 +1,70 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_recorder.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server MCAP Recorder
+**
+***************************************************************/
+
+#ifndef FOXDBG_RECORDER_H
+#define FOXDBG_RECORDER_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "foxdbg_channel.h"
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/* encoded messages waiting for the I/O thread, newer ones are dropped beyond this */
+#define FOXDBG_RECORDER_QUEUE_SIZE (64U * 1024U * 1024U)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* create path and start the I/O thread, false if already recording or the file cannot be opened */
+bool foxdbg_recorder_open(const char *path);
+
+/* write out what is queued, finish the file with its summary and stop the I/O thread */
+void foxdbg_recorder_close(void);
+
+bool foxdbg_recorder_active(void);
+
+/*
+ * queue one json message of a channel. the channel and its schema are
+ * added to the file the first time they are seen, schema may be empty for
+ * well known schema names. called from the server thread, the data is
+ * copied, the strings must outlive the recording.
+ */
+void foxdbg_recorder_write(
+    int channel_id, const char *topic, const char *schema_name, const char *schema,
+    uint64_t log_time, uint64_t publish_time,
+    const uint8_t *data, size_t size
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_RECORDER_H */
@@ -22,6 +22,7 @@
 #include "foxdbg_buffer.h"
 
 #include "foxdbg_protocol.h"
+#include "foxdbg_time.h"
 
 #include <libwebsockets.h>
 #include <stdio.h>
@@ -29,6 +30,8 @@
 #include <chrono>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 #ifdef WIN32
     #include <windows.h>
@@ -51,17 +54,32 @@
 #define PRIORITY_HIGH       (3U)
 #define PRIORITY_CRITICAL   (4U)
 
+#define RECORD_POLL_MS      (1U)
+
 /***************************************************************
 ** MARK: TYPEDEFS
 ***************************************************************/
 
+/* foxdbg_thread_encode call waiting for the server thread */
+typedef struct
+{
+    foxdbg_channel_t *channel;
+    size_t encoded_size;
+    uint64_t encode_time;
+    bool encoded;
+    bool done;
+} encode_request_t;
 
 /***************************************************************
 ** MARK: STATIC FUNCTION DEFS
 ***************************************************************/
 
 static int foxdbg_server_thread_main();
-static int foxdbg_encoder_thread_main();
+static int foxdbg_encoder_thread_main(size_t worker_index, uint64_t start_generation);
+
+static void run_tasks(size_t worker_index);
+static void serve_encode_request(void);
+static void fail_encode_request(void);
 
 static int websocket_callback(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len);
 
@@ -89,29 +107,72 @@ static std::thread foxdbg_server_thread;
 
 static std::atomic_bool running(false);
 
+/* set once the protocol is initialised on the server thread */
+static std::atomic_bool server_ready(false);
+
 static foxdbg_channel_t **channels = NULL;
 static size_t *channel_count = NULL;
 
+static foxdbg_channel_t **rx_channels = NULL;
+static size_t *rx_channel_count = NULL;
+
+static std::thread encoder_threads[FOXDBG_MAX_ENCODER_THREADS];
+static size_t encoder_thread_count = 0;
+
+/* current parallel job, published to the encoder threads under job_mutex */
+static std::mutex job_mutex;
+static std::condition_variable job_start;
+static std::condition_variable job_done;
+static uint64_t job_generation = 0;
+static foxdbg_thread_task_t job_task = NULL;
+static void *job_context = NULL;
+static size_t job_task_count = 0;
+static std::atomic<size_t> job_next_task(0);
+static size_t job_pending = 0;
+
+/* one encode request at a time, handed to the server thread under encode_mutex */
+static std::mutex encode_mutex;
+static std::condition_variable encode_done;
+static encode_request_t *encode_request = NULL;
+
 /***************************************************************
 ** MARK: PUBLIC FUNCTIONS
 ***************************************************************/
 
-void foxdbg_thread_init(foxdbg_channel_t **channels_ptr, size_t *channel_count_ptr)
+void foxdbg_thread_init(foxdbg_channel_t **channels_ptr, size_t *channel_count_ptr, foxdbg_channel_t **rx_channels_ptr, size_t *rx_channel_count_ptr)
 {   
     running.store(true);
 
     channels = channels_ptr;
     channel_count = channel_count_ptr;
 
+    rx_channels = rx_channels_ptr;
+    rx_channel_count = rx_channel_count_ptr;
+
+    /* leave one core for the server thread */
+    size_t cores = get_core_count();
+    encoder_thread_count = (cores > 1) ? (cores - 1) : 0;
+
+    if (encoder_thread_count > FOXDBG_MAX_ENCODER_THREADS)
+    {
+        encoder_thread_count = FOXDBG_MAX_ENCODER_THREADS;
+    }
+
+    for (size_t i = 0; i < encoder_thread_count; ++i)
+    {
+        encoder_threads[i] = std::thread(foxdbg_encoder_thread_main, i + 1, job_generation);
+    }
+
     foxdbg_server_thread = std::thread(foxdbg_server_thread_main);
 }
 
 void foxdbg_thread_shutdown(void)
 {
-    lws_cancel_service(context);
-
+    /* clear the flag first so the woken lws_service loop sees it */
     running.store(false);
 
+    lws_cancel_service(context);
+
     try
     {
         if (foxdbg_server_thread.joinable())
@@ -123,7 +184,113 @@ void foxdbg_thread_shutdown(void)
     {
         /* thread error */
     }
-    
+
+    {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        job_generation++;
+    }
+    job_start.notify_all();
+
+    for (size_t i = 0; i < encoder_thread_count; ++i)
+    {
+        try
+        {
+            if (encoder_threads[i].joinable())
+            {
+                encoder_threads[i].join();
+            }
+        }
+        catch (...)
+        {
+            /* thread error */
+        }
+    }
+
+    encoder_thread_count = 0;
+}
+
+void foxdbg_thread_wake(void)
+{
+    if (context)
+    {
+        lws_cancel_service(context);
+    }
+}
+
+bool foxdbg_thread_encode(foxdbg_channel_t *channel, size_t *encoded_size, uint64_t *encode_time_ns)
+{
+    encode_request_t request = { channel, 0, 0, false, false };
+
+    std::unique_lock<std::mutex> lock(encode_mutex);
+
+    /* wait for any other caller's request to be taken first */
+    encode_done.wait(lock, [] { return encode_request == NULL || !server_ready.load(); });
+
+    if (!server_ready.load())
+    {
+        return false;
+    }
+
+    encode_request = &request;
+    lws_cancel_service(context);
+
+    encode_done.wait(lock, [&] { return request.done; });
+
+    if (request.encoded)
+    {
+        *encoded_size = request.encoded_size;
+
+        if (encode_time_ns)
+        {
+            *encode_time_ns = request.encode_time;
+        }
+    }
+
+    return request.encoded;
+}
+
+size_t foxdbg_thread_worker_count(void)
+{
+    return encoder_thread_count + 1;
+}
+
+void foxdbg_thread_parallel(foxdbg_thread_task_t task, void *context, size_t task_count)
+{
+    if (task_count == 0)
+    {
+        return;
+    }
+
+    if (encoder_thread_count == 0 || task_count == 1)
+    {
+        for (size_t i = 0; i < task_count; ++i)
+        {
+            task(context, i, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(job_mutex);
+
+        job_task = task;
+        job_context = context;
+        job_task_count = task_count;
+        job_next_task.store(0);
+        job_pending = encoder_thread_count;
+        job_generation++;
+    }
+    job_start.notify_all();
+
+    /* the caller works through the queue too rather than idling */
+    run_tasks(0);
+
+    std::unique_lock<std::mutex> lock(job_mutex);
+    job_done.wait(lock, [] { return job_pending == 0; });
+
+    job_task = NULL;
+    job_context = NULL;
+    job_task_count = 0;
 }
 
 /***************************************************************
@@ -151,21 +318,125 @@ int foxdbg_server_thread_main()
         fprintf(stderr, "libwebsockets init failed\n");
     }
 
-    foxdbg_protocol_init(context, channels, channel_count);
+    foxdbg_protocol_init(context, channels, channel_count, rx_channels, rx_channel_count);
+
+    {
+        std::lock_guard<std::mutex> lock(encode_mutex);
+        server_ready.store(true);
+    }
 
     printf("FOXDBG: Server started on port %d\n", FOXDBG_PORT);
 
     while (running.load()) 
     {
-        lws_service(context, 0);
+        if (foxdbg_protocol_is_recording() && !foxdbg_protocol_has_client())
+        {
+            /* no writeable callbacks drive the transmit loop, poll for payloads instead */
+            lws_service(context, -1);
+            foxdbg_protocol_transmit_subscriptions();
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(RECORD_POLL_MS));
+        }
+        else
+        {
+            lws_service(context, 0);
+        }
+
+        serve_encode_request();
     }
 
+    fail_encode_request();
     foxdbg_protocol_shutdown();
 
     printf("Server thread exiting...\n");
     return 0;
 }
 
+static int foxdbg_encoder_thread_main(size_t worker_index, uint64_t start_generation)
+{
+    set_thread_priority(PRIORITY_NORMAL);
+
+    uint64_t seen_generation = start_generation;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(job_mutex);
+            job_start.wait(lock, [&] { return job_generation != seen_generation; });
+            seen_generation = job_generation;
+
+            if (!running.load())
+            {
+                break;
+            }
+        }
+
+        run_tasks(worker_index);
+
+        {
+            std::lock_guard<std::mutex> lock(job_mutex);
+            job_pending--;
+        }
+        job_done.notify_one();
+    }
+
+    return 0;
+}
+
+/* encode on the thread that owns the protocol state, and only when nothing else uses it */
+static void serve_encode_request(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(encode_mutex);
+
+        if (!encode_request)
+        {
+            return;
+        }
+
+        encode_request->encoded = !foxdbg_protocol_has_client() && !foxdbg_protocol_is_recording();
+
+        if (encode_request->encoded)
+        {
+            uint64_t start = foxdbg_time_ns();
+            encode_request->encoded_size = foxdbg_protocol_encode(encode_request->channel);
+            encode_request->encode_time = foxdbg_time_ns() - start;
+        }
+
+        encode_request->done = true;
+        encode_request = NULL;
+    }
+
+    encode_done.notify_all();
+}
+
+/* the server is stopping, refuse whatever is waiting */
+static void fail_encode_request(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(encode_mutex);
+        server_ready.store(false);
+
+        if (encode_request)
+        {
+            encode_request->done = true;
+            encode_request = NULL;
+        }
+    }
+
+    encode_done.notify_all();
+}
+
+static void run_tasks(size_t worker_index)
+{
+    size_t task_index;
+
+    while ((task_index = job_next_task.fetch_add(1)) < job_task_count)
+    {
+        job_task(job_context, task_index, worker_index);
+    }
+}
+
 static int websocket_callback(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len)
 {
     
@@ -187,7 +458,7 @@ static int websocket_callback(struct lws *wsi, enum lws_callback_reasons reason,
 
         case LWS_CALLBACK_RECEIVE:
         {
-            foxdbg_protocol_receive((char *)in, len);
+            foxdbg_protocol_receive((const char *)in, len, lws_is_final_fragment(wsi) && lws_remaining_packet_payload(wsi) == 0);
         } break;
 
         case LWS_CALLBACK_CLOSED:
@@ -276,9 +547,7 @@ static int websocket_callback(struct lws *wsi, enum lws_callback_reasons reason,
 
     static size_t get_core_count() 
     {
-        struct sysinfo info;
-        sysinfo(&info);
-        return info.procs;
+        return (size_t)get_nprocs();
     }
 
     static void set_core(size_t core_id) 
@@ -28,10 +28,15 @@
 ** MARK: CONSTANTS & MACROS
 ***************************************************************/
 
+#define FOXDBG_MAX_ENCODER_THREADS (8U)
+
 /***************************************************************
 ** MARK: TYPEDEFS
 ***************************************************************/
 
+/* worker_index is 0 for the calling thread, 1..N for encoder threads */
+typedef void (*foxdbg_thread_task_t)(void *context, size_t task_index, size_t worker_index);
+
 /***************************************************************
 ** MARK: FUNCTION DEFS
 ***************************************************************/
@@ -42,11 +47,23 @@ extern "C" {
 
 
 /* start FOXDBG thread pool */
-void foxdbg_thread_init(foxdbg_channel_t **channels, size_t *channel_count);
+void foxdbg_thread_init(foxdbg_channel_t **channels, size_t *channel_count, foxdbg_channel_t **rx_channels, size_t *rx_channel_count);
 
 /* stop FOXDBG thread pool */
 void foxdbg_thread_shutdown(void);
 
+/* interrupt the server thread's wait for socket events */
+void foxdbg_thread_wake(void);
+
+/* foxdbg_protocol_encode on the server thread, false if it has not started, has a client or is recording */
+bool foxdbg_thread_encode(foxdbg_channel_t *channel, size_t *encoded_size, uint64_t *encode_time_ns);
+
+/* number of workers foxdbg_thread_parallel can spread tasks over, caller included */
+size_t foxdbg_thread_worker_count(void);
+
+/* run task_count tasks on the encoder pool and the calling thread, returns when all are done */
+void foxdbg_thread_parallel(foxdbg_thread_task_t task, void *context, size_t task_count);
+
 #ifdef __cplusplus
 }
 #endif
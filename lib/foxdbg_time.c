@@ -0,0 +1,67 @@
+/***************************************************************
+**
+** TBReAI Source File
+**
+** File         :  foxdbg_time.c
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Clock
+**
+***************************************************************/
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include "foxdbg_time.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/* 100 ns ticks between 1601-01-01 and 1970-01-01 */
+#define FILETIME_UNIX_EPOCH (116444736000000000ULL)
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: STATIC FUNCTION DEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: STATIC VARIABLES
+***************************************************************/
+
+/***************************************************************
+** MARK: PUBLIC FUNCTIONS
+***************************************************************/
+
+uint64_t foxdbg_time_ns(void)
+{
+#ifdef _WIN32
+    FILETIME file_time;
+    GetSystemTimePreciseAsFileTime(&file_time);
+
+    uint64_t ticks = ((uint64_t)file_time.dwHighDateTime << 32) | file_time.dwLowDateTime;
+    return (ticks - FILETIME_UNIX_EPOCH) * 100ULL;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/***************************************************************
+** MARK: STATIC FUNCTIONS
+***************************************************************/
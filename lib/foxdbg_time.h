@@ -0,0 +1,46 @@
+/***************************************************************
+**
+** TBReAI Header File
+**
+** File         :  foxdbg_time.h
+** Module       :  foxdbg
+** Author       :  SH
+** Created      :  2026-10-19 (YYYY-MM-DD)
+** License      :  MIT
+** Description  :  Foxglove Debug Server Clock
+**
+***************************************************************/
+
+#ifndef FOXDBG_TIME_H
+#define FOXDBG_TIME_H
+
+/***************************************************************
+** MARK: INCLUDES
+***************************************************************/
+
+#include <stdint.h>
+
+/***************************************************************
+** MARK: CONSTANTS & MACROS
+***************************************************************/
+
+/***************************************************************
+** MARK: TYPEDEFS
+***************************************************************/
+
+/***************************************************************
+** MARK: FUNCTION DEFS
+***************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* wall clock time in nanoseconds since the unix epoch */
+uint64_t foxdbg_time_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOXDBG_TIME_H */